@@ -0,0 +1,25 @@
+/**
+ * @file bench_main.cpp
+ * @brief Entry point of the micro-benchmark suite
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#define BENCH_HARNESS_IMPLEMENTATION
+#include "harness.h"
+#include "log.h"
+#include <iostream>
+
+/**
+ * @brief Run the registered benchmarks
+ * @param argc Argument count
+ * @param argv Arguments: [--json] [--min-time MS] [filter...]
+ * @return 0
+ */
+int main(int argc, char* argv[])
+{
+        // Game code reports events on std::cout and the logger; keep stdout machine-readable
+        std::cout.setstate(std::ios::failbit);
+        logging::logger().set_level(logging::Level::ERR);
+        return bench::run_all(argc, argv);
+}
@@ -0,0 +1,149 @@
+#include "harness.h"
+#include "fixtures.h"
+#include "client.h"
+#include "simulator.h"
+
+namespace
+{
+        constexpr uint32_t SNAPSHOT_MS    = 50;  ///< Server broadcast interval
+        constexpr uint32_t SNAPSHOT_TICKS = 3;
+
+        /**
+         * @brief Tell the client it is player 1 so the local-player paths run too
+         */
+        void assign_id(GameClient& client)
+        {
+                protocol::MessageBuffer start;
+                start.write_header(protocol::MessageType::SERVER_START_GAME);
+                start.write_uint32(1);
+                start.finalize();
+                client.process_message(start.data);
+        }
+
+        void handle_game_state(bench::State& state, uint32_t players)
+        {
+                asio::io_context io;
+                GameClient client(io);
+                assign_id(client);
+
+                std::vector<uint8_t> msg = bench::make_state_message(players, 32, 0, 0).data;
+                uint32_t timestamp       = 0;
+                uint32_t tick            = 0;
+                uint64_t handled         = 0;
+
+                while (state.keep_running())
+                {
+                        timestamp += SNAPSHOT_MS;
+                        tick      += SNAPSHOT_TICKS;
+                        bench::restamp_state_message(msg, timestamp, tick);
+                        client.process_message(msg);
+
+                        // The snapshot history is trimmed by update_interpolation; keep it at its usual size
+                        if (++handled % 16 == 0)
+                        {
+                                state.pause();
+                                client.update_interpolation(0.0f);
+                                state.resume();
+                        }
+                }
+        }
+
+        /**
+         * @brief Record the snapshots a live session broadcasts (players walking, coins collected and respawned)
+         * @param players Number of players
+         * @param count Snapshots to record
+         * @return Encoded SERVER_GAME_STATE messages, in broadcast order
+         */
+        std::vector<std::vector<uint8_t>> record_snapshots(uint32_t players, uint32_t count)
+        {
+                Simulator sim(1);
+                for (uint32_t id = 1; id <= players; ++id)
+                        sim.add_player(id);
+
+                Simulator::InputScript walk = Simulator::random_walk(1);
+                std::vector<std::vector<uint8_t>> snapshots;
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                        sim.run(SNAPSHOT_TICKS, walk, 0);
+                        snapshots.push_back(sim.session().create_state_message().data);
+                }
+                return snapshots;
+        }
+
+        /**
+         * @brief Replay recorded snapshots; steady-state ingestion should report 0 allocations
+         */
+        void handle_recorded(bench::State& state, uint32_t players)
+        {
+                asio::io_context io;
+                GameClient client(io);
+                assign_id(client);
+
+                // Ten seconds of play, looped with ever-increasing timestamps and ticks
+                std::vector<std::vector<uint8_t>> snapshots = record_snapshots(players, 200);
+                uint32_t timestamp                          = 0;
+                uint32_t tick                               = 0;
+                uint64_t handled                            = 0;
+
+                // Warm up: one full pass sizes every reusable buffer
+                for (std::vector<uint8_t>& msg : snapshots)
+                {
+                        timestamp += SNAPSHOT_MS;
+                        tick      += SNAPSHOT_TICKS;
+                        bench::restamp_state_message(msg, timestamp, tick);
+                        client.process_message(msg);
+                }
+                client.update_interpolation(0.0f);
+
+                while (state.keep_running())
+                {
+                        std::vector<uint8_t>& msg = snapshots[handled % snapshots.size()];
+                        timestamp                += SNAPSHOT_MS;
+                        tick                     += SNAPSHOT_TICKS;
+                        bench::restamp_state_message(msg, timestamp, tick);
+                        client.process_message(msg);
+
+                        if (++handled % 16 == 0)
+                        {
+                                state.pause();
+                                client.update_interpolation(0.0f);
+                                state.resume();
+                        }
+                }
+        }
+
+        void update_interpolation(bench::State& state, uint32_t players)
+        {
+                asio::io_context io;
+                GameClient client(io);
+                assign_id(client);
+
+                // One second of snapshot history, as in steady-state play
+                std::vector<uint8_t> msg = bench::make_state_message(players, 32, 0, 0).data;
+                for (uint32_t i = 1; i <= 20; ++i)
+                {
+                        bench::restamp_state_message(msg, i * SNAPSHOT_MS, i * SNAPSHOT_TICKS);
+                        client.process_message(msg);
+                }
+
+                while (state.keep_running())
+                        client.update_interpolation(1.0f / 60.0f);
+        }
+
+        bench::Registrar handle_16("client/handle_game_state/players:16",
+                                   [](bench::State& s) { handle_game_state(s, 16); });
+        bench::Registrar handle_64("client/handle_game_state/players:64",
+                                   [](bench::State& s) { handle_game_state(s, 64); });
+        bench::Registrar handle_255("client/handle_game_state/players:255",
+                                    [](bench::State& s) { handle_game_state(s, 255); });
+        bench::Registrar recorded_16("client/handle_game_state/recorded/players:16",
+                                     [](bench::State& s) { handle_recorded(s, 16); });
+        bench::Registrar recorded_64("client/handle_game_state/recorded/players:64",
+                                     [](bench::State& s) { handle_recorded(s, 64); });
+        bench::Registrar interp_16("client/update_interpolation/players:16",
+                                   [](bench::State& s) { update_interpolation(s, 16); });
+        bench::Registrar interp_64("client/update_interpolation/players:64",
+                                   [](bench::State& s) { update_interpolation(s, 64); });
+        bench::Registrar interp_255("client/update_interpolation/players:255",
+                                    [](bench::State& s) { update_interpolation(s, 255); });
+}  // namespace
@@ -0,0 +1,140 @@
+/**
+ * @file collision_bench.cpp
+ * @brief Micro-benchmark: linear coin scan vs uniform-grid broad phase
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#include "harness.h"
+#include "protocol.h"
+#include "spatial_grid.h"
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+        constexpr float MAP_WIDTH     = 800.0f;
+        constexpr float MAP_HEIGHT    = 600.0f;
+        constexpr float COIN_RADIUS   = 20.0f;
+        constexpr float PLAYER_RADIUS = 25.0f;
+        constexpr float THRESHOLD     = PLAYER_RADIUS + COIN_RADIUS;
+
+        /**
+         * @brief Same test the session used before the grid: two map lookups per coin
+         */
+        bool scan_collision(const std::unordered_map<uint32_t, protocol::PlayerState>& players,
+                            const std::unordered_map<uint32_t, protocol::CoinState>& coins,
+                            uint32_t player_id,
+                            uint32_t coin_id)
+        {
+                auto pit = players.find(player_id);
+                auto cit = coins.find(coin_id);
+                if (pit == players.end() || cit == coins.end())
+                        return false;
+
+                float dx = pit->second.position.x - cit->second.position.x;
+                float dy = pit->second.position.y - cit->second.position.y;
+                return dx * dx + dy * dy < THRESHOLD * THRESHOLD;
+        }
+
+        /**
+         * @struct World
+         * @brief Randomly placed players and coins, both in maps and in the grid
+         */
+        struct World
+        {
+                std::unordered_map<uint32_t, protocol::PlayerState> players;
+                std::unordered_map<uint32_t, protocol::CoinState> coins;
+                SpatialGrid grid{MAP_WIDTH, MAP_HEIGHT, THRESHOLD};
+
+                World(size_t num_coins, size_t num_players)
+                {
+                        std::mt19937 rng(42);
+                        std::uniform_real_distribution<float> dx(0.0f, MAP_WIDTH);
+                        std::uniform_real_distribution<float> dy(0.0f, MAP_HEIGHT);
+
+                        for (uint32_t i = 1; i <= num_players; ++i)
+                        {
+                                protocol::Vec2 pos(dx(rng), dy(rng));
+                                players[i] = protocol::PlayerState{i, pos, protocol::Vec2(), 0, 0, 0};
+                        }
+
+                        for (uint32_t i = 1; i <= num_coins; ++i)
+                        {
+                                protocol::CoinState c{i, protocol::Vec2(dx(rng), dy(rng))};
+                                coins[i] = c;
+                                grid.insert(c.id, c.position);
+                        }
+                }
+
+                /**
+                 * @brief One "tick" of the linear scan: every player tests against every coin
+                 */
+                size_t scan_tick() const
+                {
+                        size_t hits = 0;
+                        for (const auto& [pid, player] : players)
+                                for (const auto& [cid, coin] : coins)
+                                        hits += scan_collision(players, coins, pid, cid);
+                        return hits;
+                }
+
+                /**
+                 * @brief One "tick" of the grid: every player tests the coins in its neighbouring cells
+                 */
+                size_t grid_tick() const
+                {
+                        size_t hits = 0;
+                        for (const auto& [pid, player] : players)
+                        {
+                                const protocol::Vec2 p = player.position;
+                                grid.query(p,
+                                           THRESHOLD,
+                                           [&](const SpatialGrid::Entry& e)
+                                           {
+                                                   float ddx = p.x - e.position.x;
+                                                   float ddy = p.y - e.position.y;
+                                                   hits += ddx * ddx + ddy * ddy < THRESHOLD * THRESHOLD;
+                                           });
+                        }
+                        return hits;
+                }
+        };
+
+        void scan(bench::State& state, size_t num_coins, size_t num_players)
+        {
+                World world(num_coins, num_players);
+                while (state.keep_running())
+                        bench::do_not_optimize(world.scan_tick());
+        }
+
+        void grid(bench::State& state, size_t num_coins, size_t num_players)
+        {
+                World world(num_coins, num_players);
+                if (world.grid_tick() != world.scan_tick())
+                        std::fprintf(stderr, "collision/grid: hit count differs from the linear scan\n");
+
+                while (state.keep_running())
+                        bench::do_not_optimize(world.grid_tick());
+        }
+
+        // Every coin count against every player count, scan and grid side by side
+        const bool registered = []()
+        {
+                for (size_t num_coins : {100, 1000, 10000})
+                {
+                        for (size_t num_players : {10, 100, 500})
+                        {
+                                std::string suffix =
+                                    "/coins:" + std::to_string(num_coins) + "/players:" + std::to_string(num_players);
+                                bench::Registrar("collision/scan" + suffix,
+                                                 [=](bench::State& s) { scan(s, num_coins, num_players); });
+                                bench::Registrar("collision/grid" + suffix,
+                                                 [=](bench::State& s) { grid(s, num_coins, num_players); });
+                        }
+                }
+                return true;
+        }();
+}  // namespace
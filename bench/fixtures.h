@@ -0,0 +1,66 @@
+/**
+ * @file fixtures.h
+ * @brief Synthetic protocol messages shared by the benchmark cases
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include "protocol.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace bench
+{
+        /**
+         * @brief Encode a SERVER_GAME_STATE message the way GameSession does
+         * @param players Number of players (ids 1..players, spread over the map)
+         * @param coins Number of coins
+         * @param timestamp Server timestamp (ms)
+         * @param tick Snapshot tick
+         * @return Finalized message
+         */
+        inline protocol::MessageBuffer make_state_message(uint32_t players,
+                                                          uint32_t coins,
+                                                          uint32_t timestamp,
+                                                          uint32_t tick)
+        {
+                protocol::MessageBuffer buf;
+                buf.write_header(protocol::MessageType::SERVER_GAME_STATE);
+                buf.write_uint32(timestamp);
+                buf.write_uint32(tick);
+                buf.write_uint8(static_cast<uint8_t>(players));
+                buf.write_uint8(static_cast<uint8_t>(coins));
+
+                for (uint32_t i = 0; i < players; ++i)
+                {
+                        protocol::Vec2 pos(25.0f + static_cast<float>((i * 37 + tick) % 750),
+                                           25.0f + static_cast<float>((i * 53 + tick) % 550));
+                        protocol::Vec2 vel(i % 2 ? 200.0f : -141.42f, i % 3 ? 0.0f : 141.42f);
+                        buf.write_player_state(protocol::PlayerState{i + 1, pos, vel, i, tick, timestamp});
+                }
+
+                for (uint32_t i = 0; i < coins; ++i)
+                {
+                        protocol::Vec2 pos(20.0f + static_cast<float>((i * 71) % 760),
+                                           20.0f + static_cast<float>((i * 29) % 560));
+                        buf.write_coin_state(protocol::CoinState{i + 1, pos});
+                }
+
+                buf.finalize();
+                return buf;
+        }
+
+        /**
+         * @brief Overwrite the timestamp and tick of an encoded state message in place
+         * @param data Message bytes from make_state_message()
+         * @param timestamp New server timestamp (ms)
+         * @param tick New tick
+         */
+        inline void restamp_state_message(std::vector<uint8_t>& data, uint32_t timestamp, uint32_t tick)
+        {
+                std::memcpy(data.data() + sizeof(protocol::MessageHeader), &timestamp, sizeof(timestamp));
+                std::memcpy(data.data() + sizeof(protocol::MessageHeader) + sizeof(timestamp), &tick, sizeof(tick));
+        }
+}  // namespace bench
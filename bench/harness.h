@@ -0,0 +1,305 @@
+/**
+ * @file harness.h
+ * @brief Minimal self-contained micro-benchmark harness with allocation counting
+ * @author NetworkGame Project
+ * @date 2024
+ *
+ * Usage:
+ * @code
+ * static bench::Registrar reg("encode/players:16", [](bench::State& state) {
+ *         Fixture f;                       // setup is not timed
+ *         while (state.keep_running())
+ *                 bench::do_not_optimize(f.encode());
+ * });
+ * @endcode
+ *
+ * Exactly one translation unit must define BENCH_HARNESS_IMPLEMENTATION before
+ * including this header. That unit gets the global operator new/delete
+ * replacements that count allocations, and should call bench::run_all() from main().
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+        /**
+         * @brief Process-wide allocation counters, bumped by the replaced operator new
+         */
+        inline std::atomic<uint64_t>& alloc_count()
+        {
+                static std::atomic<uint64_t> count{0};
+                return count;
+        }
+
+        inline std::atomic<uint64_t>& alloc_bytes()
+        {
+                static std::atomic<uint64_t> bytes{0};
+                return bytes;
+        }
+
+        /**
+         * @brief Keep a value alive so the compiler cannot drop the computation producing it
+         */
+        template <typename T>
+        inline void do_not_optimize(const T& value)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+                asm volatile("" : : "r,m"(value) : "memory");
+#else
+                static volatile const void* sink;
+                sink = &value;
+#endif
+        }
+
+        /**
+         * @class State
+         * @brief Iteration control handed to a benchmark body
+         *
+         * The timed region starts at the first keep_running() call and ends when
+         * it returns false, so setup before the loop is excluded. Allocation
+         * counters are sampled at the same points.
+         */
+        class State
+        {
+        public:
+                explicit State(uint64_t iterations) : target_(iterations), done_(0) {}
+
+                /**
+                 * @brief Advance to the next iteration
+                 * @return true while iterations remain
+                 */
+                bool keep_running()
+                {
+                        if (!started_)
+                        {
+                                started_      = true;
+                                allocs_start_ = alloc_count().load(std::memory_order_relaxed);
+                                bytes_start_  = alloc_bytes().load(std::memory_order_relaxed);
+                                start_        = std::chrono::steady_clock::now();
+                        }
+
+                        if (done_ < target_)
+                        {
+                                ++done_;
+                                return true;
+                        }
+
+                        end_        = std::chrono::steady_clock::now();
+                        allocs_end_ = alloc_count().load(std::memory_order_relaxed);
+                        bytes_end_  = alloc_bytes().load(std::memory_order_relaxed);
+                        return false;
+                }
+
+                /**
+                 * @brief Stop the clock and allocation counters (e.g. for periodic housekeeping)
+                 */
+                void pause()
+                {
+                        pause_at_     = std::chrono::steady_clock::now();
+                        pause_allocs_ = alloc_count().load(std::memory_order_relaxed);
+                        pause_bytes_  = alloc_bytes().load(std::memory_order_relaxed);
+                }
+
+                /**
+                 * @brief Restart the clock and counters after pause()
+                 */
+                void resume()
+                {
+                        start_        += std::chrono::steady_clock::now() - pause_at_;
+                        allocs_start_ += alloc_count().load(std::memory_order_relaxed) - pause_allocs_;
+                        bytes_start_  += alloc_bytes().load(std::memory_order_relaxed) - pause_bytes_;
+                }
+
+                uint64_t iterations() const { return done_; }
+                double elapsed_ns() const { return std::chrono::duration<double, std::nano>(end_ - start_).count(); }
+                uint64_t allocations() const { return allocs_end_ - allocs_start_; }
+                uint64_t allocated_bytes() const { return bytes_end_ - bytes_start_; }
+
+        private:
+                uint64_t target_;
+                uint64_t done_;
+                bool started_          = false;
+                uint64_t allocs_start_ = 0;
+                uint64_t allocs_end_   = 0;
+                uint64_t bytes_start_  = 0;
+                uint64_t bytes_end_    = 0;
+                uint64_t pause_allocs_ = 0;
+                uint64_t pause_bytes_  = 0;
+                std::chrono::steady_clock::time_point start_;
+                std::chrono::steady_clock::time_point end_;
+                std::chrono::steady_clock::time_point pause_at_;
+        };
+
+        using BenchFn = std::function<void(State&)>;
+
+        /**
+         * @struct Case
+         * @brief Registered benchmark
+         */
+        struct Case
+        {
+                std::string name;
+                BenchFn fn;
+        };
+
+        inline std::vector<Case>& registry()
+        {
+                static std::vector<Case> cases;
+                return cases;
+        }
+
+        /**
+         * @struct Registrar
+         * @brief Registers a benchmark from a static initializer
+         */
+        struct Registrar
+        {
+                Registrar(std::string name, BenchFn fn) { registry().push_back(Case{std::move(name), std::move(fn)}); }
+        };
+
+        /**
+         * @struct Result
+         * @brief Per-operation figures for one case
+         */
+        struct Result
+        {
+                std::string name;
+                uint64_t iterations;
+                double ns_per_op;
+                double allocs_per_op;
+                double bytes_per_op;
+        };
+
+        /**
+         * @brief Run one case, growing the iteration count until a run lasts min_time_ms
+         */
+        inline Result run_case(const Case& c, double min_time_ms)
+        {
+                uint64_t iterations = 1;
+                for (;;)
+                {
+                        State state(iterations);
+                        c.fn(state);
+
+                        double ns = state.elapsed_ns();
+                        if (ns >= min_time_ms * 1e6 || iterations >= (1ull << 40))
+                        {
+                                double n = static_cast<double>(state.iterations());
+                                return Result{c.name,
+                                              state.iterations(),
+                                              ns / n,
+                                              static_cast<double>(state.allocations()) / n,
+                                              static_cast<double>(state.allocated_bytes()) / n};
+                        }
+
+                        // Aim straight for the target with 20% headroom, growing at most 10x per round
+                        double scale = ns > 0.0 ? (min_time_ms * 1e6 * 1.2) / ns : 10.0;
+                        scale        = std::min(10.0, std::max(2.0, scale));
+                        iterations   = static_cast<uint64_t>(static_cast<double>(iterations) * scale);
+                }
+        }
+
+        /**
+         * @brief Run every registered case whose name contains one of the filters
+         *
+         * Arguments: [--json] [--min-time MS] [filter...]. Output is CSV by default
+         * (one header line, one row per case) or one JSON object per line.
+         */
+        inline int run_all(int argc, char* argv[])
+        {
+                bool json          = false;
+                double min_time_ms = 200.0;
+                std::vector<std::string> filters;
+
+                for (int i = 1; i < argc; ++i)
+                {
+                        if (std::strcmp(argv[i], "--json") == 0)
+                                json = true;
+                        else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+                                min_time_ms = std::atof(argv[++i]);
+                        else
+                                filters.push_back(argv[i]);
+                }
+
+                if (!json)
+                        std::printf("name,iterations,ns_per_op,allocs_per_op,bytes_per_op\n");
+
+                for (const Case& c : registry())
+                {
+                        bool selected = filters.empty();
+                        for (const std::string& f : filters)
+                                selected = selected || c.name.find(f) != std::string::npos;
+                        if (!selected)
+                                continue;
+
+                        Result r = run_case(c, min_time_ms);
+                        if (json)
+                                std::printf(
+                                    "{\"name\":\"%s\",\"iterations\":%llu,\"ns_per_op\":%.2f,\"allocs_per_op\":%.3f,"
+                                    "\"bytes_per_op\":%.1f}\n",
+                                    r.name.c_str(),
+                                    static_cast<unsigned long long>(r.iterations),
+                                    r.ns_per_op,
+                                    r.allocs_per_op,
+                                    r.bytes_per_op);
+                        else
+                                std::printf("%s,%llu,%.2f,%.3f,%.1f\n",
+                                            r.name.c_str(),
+                                            static_cast<unsigned long long>(r.iterations),
+                                            r.ns_per_op,
+                                            r.allocs_per_op,
+                                            r.bytes_per_op);
+                        std::fflush(stdout);
+                }
+                return 0;
+        }
+}  // namespace bench
+
+#ifdef BENCH_HARNESS_IMPLEMENTATION
+
+void* operator new(std::size_t size)
+{
+        bench::alloc_count().fetch_add(1, std::memory_order_relaxed);
+        bench::alloc_bytes().fetch_add(size, std::memory_order_relaxed);
+        if (void* p = std::malloc(size ? size : 1))
+                return p;
+        throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+        return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+        std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+        std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+        std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+        std::free(p);
+}
+
+#endif
@@ -0,0 +1,124 @@
+/**
+ * @file kernel_bench.cpp
+ * @brief Micro-benchmark: scalar vs SIMD movement and overlap kernels
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#include "harness.h"
+#include "sim_kernels.h"
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+        const sim::MoveParams PARAMS{200.0f, 1.0f / 60.0f, 0.01f, 25.0f, 775.0f, 25.0f, 575.0f};
+        constexpr float RADIUS_SQ = 45.0f * 45.0f;
+
+        /**
+         * @struct Entities
+         * @brief Random positions and movement directions in SoA layout
+         */
+        struct Entities
+        {
+                std::vector<float> x, y, dx, dy;
+                std::vector<uint8_t> moved;
+
+                explicit Entities(size_t n) : x(n), y(n), dx(n), dy(n), moved(n)
+                {
+                        std::mt19937 rng(7);
+                        std::uniform_real_distribution<float> pos(0.0f, 800.0f);
+                        std::uniform_int_distribution<int> dir(-1, 1);
+
+                        for (size_t i = 0; i < n; ++i)
+                        {
+                                x[i]  = pos(rng);
+                                y[i]  = pos(rng) * 0.75f;
+                                dx[i] = static_cast<float>(dir(rng));
+                                dy[i] = static_cast<float>(dir(rng));
+                        }
+                }
+        };
+
+        /**
+         * @brief Advance every entity one tick with the scalar or the dispatched kernel
+         */
+        void move(Entities& e, bool simd)
+        {
+                auto kernel = simd ? sim::integrate : sim::integrate_scalar;
+                kernel(e.x.data(), e.y.data(), e.dx.data(), e.dy.data(), e.moved.data(), e.x.size(), PARAMS);
+        }
+
+        /**
+         * @brief Collect the entities within range of the map centre
+         */
+        size_t hit_test(const Entities& e, bool simd, uint32_t* out)
+        {
+                auto kernel = simd ? sim::overlaps : sim::overlaps_scalar;
+                return kernel(400.0f, 300.0f, e.x.data(), e.y.data(), e.x.size(), RADIUS_SQ, out);
+        }
+
+        /**
+         * @brief Both paths from the same start must agree bit for bit
+         */
+        void check_kernels(size_t n)
+        {
+                Entities s(n), v(n);
+                for (int step = 0; step < 120; ++step)
+                {
+                        move(s, false);
+                        move(v, true);
+                }
+                if (s.x != v.x || s.y != v.y || s.moved != v.moved)
+                        std::fprintf(stderr, "kernel/integrate: %s differs from scalar (n=%zu)\n", sim::backend(), n);
+
+                std::vector<uint32_t> hits_s(n), hits_v(n);
+                size_t count_s = hit_test(s, false, hits_s.data());
+                size_t count_v = hit_test(s, true, hits_v.data());
+                if (count_s != count_v || std::memcmp(hits_s.data(), hits_v.data(), count_s * sizeof(uint32_t)) != 0)
+                        std::fprintf(stderr, "kernel/overlaps: %s differs from scalar (n=%zu)\n", sim::backend(), n);
+        }
+
+        void integrate(bench::State& state, size_t n, bool simd)
+        {
+                Entities e(n);
+                if (simd)
+                        check_kernels(n);
+
+                while (state.keep_running())
+                {
+                        move(e, simd);
+                        bench::do_not_optimize(e.x.data());
+                }
+        }
+
+        void overlaps(bench::State& state, size_t n, bool simd)
+        {
+                Entities e(n);
+                std::vector<uint32_t> hits(n);
+
+                while (state.keep_running())
+                        bench::do_not_optimize(hit_test(e, simd, hits.data()));
+        }
+
+        // "simd" is whichever backend sim_kernels was built with (see sim::backend())
+        const bool registered = []()
+        {
+                for (size_t n : {1000, 10000, 100000})
+                {
+                        std::string suffix = "/n:" + std::to_string(n);
+                        bench::Registrar("kernel/integrate/scalar" + suffix,
+                                         [=](bench::State& s) { integrate(s, n, false); });
+                        bench::Registrar("kernel/integrate/simd" + suffix,
+                                         [=](bench::State& s) { integrate(s, n, true); });
+                        bench::Registrar("kernel/overlaps/scalar" + suffix,
+                                         [=](bench::State& s) { overlaps(s, n, false); });
+                        bench::Registrar("kernel/overlaps/simd" + suffix,
+                                         [=](bench::State& s) { overlaps(s, n, true); });
+                }
+                return true;
+        }();
+}  // namespace
@@ -0,0 +1,46 @@
+#include "harness.h"
+#include "log.h"
+
+namespace
+{
+        /**
+         * @brief Sink that discards records, so only the caller-side cost is measured
+         */
+        class NullSink : public logging::Sink
+        {
+        public:
+                void write(const logging::Record&) override {}
+                void flush() override {}
+        };
+
+        void log_call(bench::State& state, bool with_string)
+        {
+                logging::Logger logger;
+                logger.set_sink(std::make_unique<NullSink>());
+                const std::string reason = "Connection reset by peer";
+
+                uint64_t i = 0;
+                while (state.keep_running())
+                {
+                        if (with_string)
+                                logger.write(logging::Level::WARN, "Connection {} error: {}", i, reason);
+                        else
+                                logger.write(logging::Level::INFO,
+                                             "Player {} collected coin. Score: {} (input lag: {} ms)",
+                                             i,
+                                             7u,
+                                             3.5);
+
+                        // Let the writer catch up before the queue fills, so every call is a real push
+                        if (++i % (logging::Logger::QUEUE_CAPACITY / 2) == 0)
+                        {
+                                state.pause();
+                                logger.flush();
+                                state.resume();
+                        }
+                }
+        }
+
+        bench::Registrar log_numbers("log/write/numbers:3", [](bench::State& s) { log_call(s, false); });
+        bench::Registrar log_string("log/write/numbers:1/string:1", [](bench::State& s) { log_call(s, true); });
+}  // namespace
@@ -0,0 +1,50 @@
+#include "harness.h"
+#include "fixtures.h"
+
+namespace
+{
+        void encode_state(bench::State& state, uint32_t players, uint32_t coins)
+        {
+                while (state.keep_running())
+                {
+                        protocol::MessageBuffer msg = bench::make_state_message(players, coins, 1000, 60);
+                        bench::do_not_optimize(msg.data.data());
+                }
+        }
+
+        void decode_state(bench::State& state, uint32_t players, uint32_t coins)
+        {
+                protocol::MessageBuffer msg = bench::make_state_message(players, coins, 1000, 60);
+
+                while (state.keep_running())
+                {
+                        protocol::MessageReader reader(msg.data.data(), msg.data.size());
+                        protocol::MessageHeader header;
+                        uint32_t timestamp, tick;
+                        reader.read_header(header);
+                        reader.read_uint32(timestamp);
+                        reader.read_uint32(tick);
+                        uint8_t player_count = 0, coin_count = 0;
+                        reader.read_uint8(player_count);
+                        reader.read_uint8(coin_count);
+
+                        protocol::PlayerState ps;
+                        for (uint8_t i = 0; i < player_count; ++i)
+                                reader.read_player_state(ps);
+                        protocol::CoinState cs;
+                        for (uint8_t i = 0; i < coin_count; ++i)
+                                reader.read_coin_state(cs);
+                        bench::do_not_optimize(ps);
+                        bench::do_not_optimize(cs);
+                }
+        }
+
+        bench::Registrar encode_16("message_buffer/encode_state/players:16/coins:32",
+                                   [](bench::State& s) { encode_state(s, 16, 32); });
+        bench::Registrar encode_255("message_buffer/encode_state/players:255/coins:255",
+                                    [](bench::State& s) { encode_state(s, 255, 255); });
+        bench::Registrar decode_16("message_reader/decode_state/players:16/coins:32",
+                                   [](bench::State& s) { decode_state(s, 16, 32); });
+        bench::Registrar decode_255("message_reader/decode_state/players:255/coins:255",
+                                    [](bench::State& s) { decode_state(s, 255, 255); });
+}  // namespace
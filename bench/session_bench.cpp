@@ -0,0 +1,57 @@
+#include "harness.h"
+#include "simulator.h"
+
+namespace
+{
+        /**
+         * @brief Session with players spread out by two seconds of random walking
+         */
+        std::unique_ptr<Simulator> make_populated(uint32_t players)
+        {
+                auto sim = std::make_unique<Simulator>(1);
+                for (uint32_t id = 1; id <= players; ++id)
+                        sim->add_player(id);
+                sim->run(2 * GameSession::TICK_RATE, Simulator::random_walk(1), 0);
+                return sim;
+        }
+
+        void create_state_message(bench::State& state, uint32_t players)
+        {
+                auto sim = make_populated(players);
+                while (state.keep_running())
+                {
+                        protocol::MessageBuffer msg = sim->session().create_state_message();
+                        bench::do_not_optimize(msg.data.data());
+                }
+        }
+
+        void tick_with_inputs(bench::State& state, uint32_t players)
+        {
+                auto sim             = make_populated(players);
+                GameSession& session = sim->session();
+                protocol::ClientInput input{1.0f, 0.0f, 0, 0, 0};
+
+                while (state.keep_running())
+                {
+                        // Everyone moves, so every player runs the coin collision query
+                        input.seq++;
+                        input.dx = -input.dx;
+                        for (uint32_t id = 1; id <= players; ++id)
+                                session.push_input(id, input);
+                        session.tick();
+                }
+        }
+
+        bench::Registrar state_1("session/create_state_message/players:1",
+                                 [](bench::State& s) { create_state_message(s, 1); });
+        bench::Registrar state_16("session/create_state_message/players:16",
+                                  [](bench::State& s) { create_state_message(s, 16); });
+        bench::Registrar state_64("session/create_state_message/players:64",
+                                  [](bench::State& s) { create_state_message(s, 64); });
+        bench::Registrar state_255("session/create_state_message/players:255",
+                                   [](bench::State& s) { create_state_message(s, 255); });
+        bench::Registrar tick_16("session/tick_with_inputs/players:16", [](bench::State& s) { tick_with_inputs(s, 16); });
+        bench::Registrar tick_64("session/tick_with_inputs/players:64", [](bench::State& s) { tick_with_inputs(s, 64); });
+        bench::Registrar tick_255("session/tick_with_inputs/players:255",
+                                  [](bench::State& s) { tick_with_inputs(s, 255); });
+}  // namespace
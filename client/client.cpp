@@ -1,52 +1,172 @@
 #include "client.h"
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 
+namespace
+{
+        bool by_id(const InterpolatedPlayer& a, const InterpolatedPlayer& b) { return a.id < b.id; }
+
+        /**
+         * @brief Cubic Hermite interpolation between two snapshot entries using their velocities
+         * @param a Entry at the start of the span
+         * @param b Entry at the end of the span
+         * @param t Position in the span (0..1)
+         * @param span_s Span length in seconds (scales the velocity tangents)
+         * @return Position, kept inside the area players can occupy
+         */
+        protocol::Vec2 hermite(const SnapshotHistory::Entry& a,
+                               const SnapshotHistory::Entry& b,
+                               double t,
+                               double span_s)
+        {
+                double t2  = t * t;
+                double t3  = t2 * t;
+                double h00 = 2.0 * t3 - 3.0 * t2 + 1.0;
+                double h10 = (t3 - 2.0 * t2 + t) * span_s;
+                double h01 = -2.0 * t3 + 3.0 * t2;
+                double h11 = (t3 - t2) * span_s;
+                double x   = h00 * a.position.x + h10 * a.velocity.x + h01 * b.position.x + h11 * b.velocity.x;
+                double y   = h00 * a.position.y + h10 * a.velocity.y + h01 * b.position.y + h11 * b.velocity.y;
+
+                // The curve can overshoot a wall the player was clamped against
+                const movement::Params& p = movement::PLAYER;
+                return protocol::Vec2(std::clamp(static_cast<float>(x), p.min_x, p.max_x),
+                                      std::clamp(static_cast<float>(y), p.min_y, p.max_y));
+        }
+
+        /**
+         * @brief Dead-reckon a snapshot entry forward along its velocity
+         * @param e Newest entry for the player
+         * @param ahead_s Seconds past the entry's timestamp
+         * @return Position, kept inside the area players can occupy
+         */
+        protocol::Vec2 dead_reckon(const SnapshotHistory::Entry& e, double ahead_s)
+        {
+                const movement::Params& p = movement::PLAYER;
+                float x                   = e.position.x + e.velocity.x * static_cast<float>(ahead_s);
+                float y                   = e.position.y + e.velocity.y * static_cast<float>(ahead_s);
+                return protocol::Vec2(std::clamp(x, p.min_x, p.max_x), std::clamp(y, p.min_y, p.max_y));
+        }
+
+        uint64_t to_us(std::chrono::steady_clock::time_point t)
+        {
+                return static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(t.time_since_epoch()).count());
+        }
+
+        uint64_t steady_now_us() { return to_us(std::chrono::steady_clock::now()); }
+
+        uint64_t pack_input(float dx, float dy)
+        {
+                uint32_t bits[2];
+                std::memcpy(&bits[0], &dx, sizeof(float));
+                std::memcpy(&bits[1], &dy, sizeof(float));
+                return static_cast<uint64_t>(bits[0]) | (static_cast<uint64_t>(bits[1]) << 32);
+        }
+
+        void unpack_input(uint64_t packed, float& dx, float& dy)
+        {
+                uint32_t bits[2] = {static_cast<uint32_t>(packed), static_cast<uint32_t>(packed >> 32)};
+                std::memcpy(&dx, &bits[0], sizeof(float));
+                std::memcpy(&dy, &bits[1], sizeof(float));
+        }
+
+        /**
+         * @brief Place a 32-bit server stamp on the client's 64-bit timeline, next to a known point on it
+         * @param stamp Server milliseconds, truncated to 32 bits (wraps every 49.7 days)
+         * @param near Unwrapped time within 2^31 ms of the stamp
+         */
+        uint64_t unwrap_stamp(uint32_t stamp, uint64_t near)
+        {
+                auto delta = static_cast<int32_t>(stamp - static_cast<uint32_t>(near));
+                return static_cast<uint64_t>(static_cast<int64_t>(near) + delta);
+        }
+}  // namespace
+
 GameClient::GameClient(asio::io_context& io)
-    : io_(io), socket_(io), latency_timer_(io), connected_(false), my_player_id_(0)
+    : io_(io), socket_(io), inbox_retry_timer_(io), sync_timer_(io), connected_(false), my_player_id_(0)
 {
         next_input_seq_ = 1;
         ping_ms_        = 0.0f;
 }
 
-void GameClient::apply_local_input(float dx, float dy, float dt)
+void GameClient::predict(uint32_t seq, float dx, float dy)
 {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (my_player_id_ == 0)
+        InterpolatedPlayer* me = find_player(my_player_id_);
+        if (!me)
                 return;
 
-        auto it = players_.find(my_player_id_);
-        if (it == players_.end())
+        // Client-side prediction: the server will apply this input as one movement step,
+        // so apply the identical step now and shift the rendered position by the same amount
+        protocol::Vec2 before = me->current_pos;
+        if (!movement::step(me->current_pos.x, me->current_pos.y, dx, dy))
                 return;
 
-        // Simple client-side prediction: move the local player's render and
-        // current positions immediately using the same speed used on server.
-        const float PLAYER_SPEED = 150.0f;
+        me->render_pos.x += me->current_pos.x - before.x;
+        me->render_pos.y += me->current_pos.y - before.y;
 
-        float len                = std::sqrt(dx * dx + dy * dy);
-        if (len > 0.001f)
+        // The server tests pickups only after a player moves, against the coins this client was shown
+        for (const protocol::CoinState& coin : coins_)
         {
-                float nx                  = dx / len;
-                float ny                  = dy / len;
-
-                it->second.current_pos.x += nx * PLAYER_SPEED * dt;
-                it->second.current_pos.y += ny * PLAYER_SPEED * dt;
+                if (pickup_predicted(coin.id) ||
+                    !movement::touches_coin(me->current_pos.x, me->current_pos.y, coin.position.x, coin.position.y))
+                        continue;
 
-                it->second.render_pos.x  += nx * PLAYER_SPEED * dt;
-                it->second.render_pos.y  += ny * PLAYER_SPEED * dt;
+                predicted_pickups_.push_back(PredictedPickup{coin.id, seq});
+                pickups_predicted_++;
         }
 }
 
+void GameClient::resolve_pickups(uint32_t acked_seq, uint32_t score)
+{
+        // Coins vanish in the same snapshot as the score that collected them, so each point gained since the
+        // previous snapshot confirms one vanished prediction
+        uint32_t gained = score > server_score_ ? score - server_score_ : 0;
+        server_score_   = score;
+
+        auto resolved = [&](const PredictedPickup& p)
+        {
+                auto coin = std::find_if(coins_.begin(),
+                                         coins_.end(),
+                                         [&](const protocol::CoinState& c) { return c.id == p.coin_id; });
+                if (coin == coins_.end())
+                {
+                        // Gone: ours if our score rose with it, otherwise another player got there first and
+                        // the shown score drops back
+                        if (gained > 0)
+                                gained--;
+                        else
+                                pickups_rolled_back_++;
+                        return true;
+                }
+
+                // The server applied the input and the coin survived: show it again
+                if (acked_seq >= p.seq)
+                {
+                        pickups_rolled_back_++;
+                        return true;
+                }
+                return false;
+        };
+        predicted_pickups_.erase(std::remove_if(predicted_pickups_.begin(), predicted_pickups_.end(), resolved),
+                                 predicted_pickups_.end());
+}
+
+bool GameClient::pickup_predicted(uint32_t coin_id) const
+{
+        return std::any_of(predicted_pickups_.begin(),
+                           predicted_pickups_.end(),
+                           [&](const PredictedPickup& p) { return p.coin_id == coin_id; });
+}
+
 void GameClient::connect(const std::string& host, uint16_t port)
 {
         tcp::resolver resolver(io_);
         auto endpoints = resolver.resolve(host, std::to_string(port));
 
         asio::connect(socket_, endpoints);
-        {
-                std::lock_guard<std::mutex> lock(mutex_);
-                connected_ = true;
-        }
+        connected_ = true;
 
         std::cout << "Connected to server\n";
 
@@ -58,116 +178,297 @@ void GameClient::connect(const std::string& host, uint16_t port)
         asio::write(socket_, asio::buffer(msg.data));
 
         read_header();
+
+        // Clock sync is a network-stage exchange; the input stream is driven by the simulation stage
+        asio::post(io_,
+                   [this]()
+                   {
+                           send_time_request();
+                           schedule_time_sync();
+                   });
+}
+
+void GameClient::set_input(float dx, float dy)
+{
+        held_input_.store(pack_input(dx, dy), std::memory_order_relaxed);
+}
+
+GameClient::~GameClient()
+{
+        stop_simulation();
 }
 
-void GameClient::send_input(float dx, float dy)
+void GameClient::start_simulation()
 {
-        if (!connected_)
+        if (simulating_.exchange(true))
                 return;
+        simulation_thread_ = std::thread([this]() { simulation_loop(); });
+}
 
-        // Build message with sequence number and timestamp
-        protocol::MessageBuffer msg;
-        msg.write_header(protocol::MessageType::CLIENT_INPUT);
-        msg.write_float(dx);
-        msg.write_float(dy);
+void GameClient::stop_simulation()
+{
+        simulating_ = false;
+        if (simulation_thread_.joinable())
+                simulation_thread_.join();
+}
 
-        auto now           = std::chrono::steady_clock::now();
-        uint32_t timestamp = static_cast<uint32_t>(
-            std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count());
+void GameClient::simulation_loop()
+{
+        // Absolute deadlines, one step per input tick; a late step samples every command it missed
+        const auto period = std::chrono::nanoseconds(1000000000 / INPUT_RATE);
+        auto last         = std::chrono::steady_clock::now();
+        auto next         = last;
+        while (simulating_)
+        {
+                auto now = std::chrono::steady_clock::now();
+                step(std::chrono::duration<float>(now - last).count());
+                last = now;
+
+                next += period;
+                if (next < now)
+                        next = now;
+                std::this_thread::sleep_until(next);
+        }
+}
 
-        uint32_t seq;
+void GameClient::step(float dt)
+{
+        auto start = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Everything the network stage framed since the previous step, in arrival order
+        while (InboundMessage* msg = inbox_.front())
         {
-                std::lock_guard<std::mutex> lock(mutex_);
-                seq = next_input_seq_++;
-                // Store pending input for reconciliation
-                pending_inputs_.push_back(PendingInput{seq, dx, dy, timestamp});
+                latency_.inbox_wait_us.record(to_us(start) - std::min(to_us(start), to_us(msg->received)));
+                apply_message(msg->data, msg->received);
+                inbox_.pop();
         }
 
-        msg.write_uint32(timestamp);
-        msg.write_uint32(seq);
-        msg.finalize();
+        // Commands that fell due since the previous step (normally exactly one)
+        const auto period = std::chrono::nanoseconds(1000000000 / INPUT_RATE);
+        if (next_sample_ == std::chrono::steady_clock::time_point())
+                next_sample_ = start;
+        while (next_sample_ <= start)
+        {
+                sample_input();
+                next_sample_ += period;
+        }
+
+        interpolate(dt);
+        publish_render_frame();
+        latency_.step_us.record(to_us(std::chrono::steady_clock::now()) - to_us(start));
+}
+
+void GameClient::sample_input()
+{
+        if (!connected_ || my_player_id_ == 0)
+                return;
+
+        uint32_t timestamp = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                       std::chrono::steady_clock::now().time_since_epoch())
+                                                       .count());
+
+        // One command per input tick, held direction or explicit stop. Store it for
+        // reconciliation and predict it exactly as the server will apply it.
+        PendingInput input{next_input_seq_++, 0.0f, 0.0f, timestamp};
+        unpack_input(held_input_.load(std::memory_order_relaxed), input.dx, input.dy);
+        pending_inputs_.push_back(input);
+        unsent_inputs_.push_back(input);
+        predict(input.seq, input.dx, input.dy);
+
+        if (++input_ticks_ % INPUTS_PER_BATCH == 0)
+                flush_inputs();
+}
+
+void GameClient::flush_inputs()
+{
+        size_t sent = 0;
+        while (sent < unsent_inputs_.size())
+        {
+                // Network stage is behind: keep the rest for the next flush rather than drop commands
+                protocol::MessageBuffer* batch = outbox_queue_.claim();
+                if (!batch)
+                        break;
+
+                size_t count = std::min(unsent_inputs_.size() - sent, MAX_BATCH_COMMANDS);
+                batch->data.clear();
+                batch->write_header(protocol::MessageType::CLIENT_INPUT_BATCH);
+                batch->write_uint32(unsent_inputs_[sent].seq);
+                batch->write_uint32(last_snapshot_tick_);  // Lets the server validate pickups against our world
+                batch->write_uint8(static_cast<uint8_t>(count));
+                for (size_t i = sent; i < sent + count; ++i)
+                {
+                        const PendingInput& pi = unsent_inputs_[i];
+                        batch->write_input_command(protocol::InputCommand{pi.dx, pi.dy, pi.timestamp});
+                }
+                batch->finalize();
+                outbox_queue_.publish();
+                sent += count;
+        }
+        if (sent == 0)
+                return;
 
-        asio::async_write(socket_, asio::buffer(msg.data), [](asio::error_code, std::size_t) {});
+        unsent_inputs_.erase(unsent_inputs_.begin(), unsent_inputs_.begin() + static_cast<std::ptrdiff_t>(sent));
+        asio::post(io_, [this]() { send_queued(); });
+}
+
+void GameClient::send_queued()
+{
+        while (protocol::MessageBuffer* msg = outbox_queue_.front())
+        {
+                queue_message(*msg);
+                outbox_queue_.pop();
+        }
+}
+
+void GameClient::queue_message(const protocol::MessageBuffer& msg)
+{
+        outbox_.insert(outbox_.end(), msg.data.begin(), msg.data.end());
+        start_write();
+}
+
+void GameClient::start_write()
+{
+        // One write at a time; messages queued meanwhile go out together with the next one
+        if (write_in_flight_ || outbox_.empty())
+                return;
+
+        writing_.swap(outbox_);
+        outbox_.clear();
+        write_in_flight_ = true;
+        asio::async_write(socket_,
+                          asio::buffer(writing_),
+                          [this](asio::error_code ec, std::size_t)
+                          {
+                                  write_in_flight_ = false;
+                                  writing_.clear();
+                                  if (ec)
+                                  {
+                                          outbox_.clear();
+                                          return;
+                                  }
+                                  start_write();
+                          });
+}
+
+void GameClient::schedule_time_sync()
+{
+        // A quick burst to converge, then a slow refresh to follow drift
+        auto interval = clock_sync_requests_ < SYNC_BURST ? SYNC_BURST_INTERVAL : SYNC_INTERVAL;
+        sync_timer_.expires_after(interval);
+        sync_timer_.async_wait(
+            [this](asio::error_code ec)
+            {
+                    if (ec)
+                            return;
+
+                    send_time_request();
+                    schedule_time_sync();
+            });
+}
+
+void GameClient::send_time_request()
+{
+        scratch_.data.clear();
+        scratch_.write_header(protocol::MessageType::CLIENT_TIME_REQUEST);
+        scratch_.write_uint64(steady_now_us());
+        scratch_.finalize();
+        queue_message(scratch_);
+        clock_sync_requests_++;
 }
 
 void GameClient::update_interpolation(float dt)
 {
         std::lock_guard<std::mutex> lock(mutex_);
+        interpolate(dt);
+        publish_render_frame();
+}
+
+void GameClient::publish_render_frame()
+{
+        RenderFrame& frame = frames_.write_buffer();
+
+        frame.players.clear();
+        for (const InterpolatedPlayer& player : players_)
+                frame.players.push_back(RenderFrame::Player{player.id, player.render_pos, player.score});
+
+        frame.coins.clear();
+        for (const protocol::CoinState& coin : coins_)
+        {
+                if (!pickup_predicted(coin.id))
+                        frame.coins.push_back(coin.position);
+        }
+
+        // Predicted pickups count towards the local score until the server's score catches up
+        for (RenderFrame::Player& player : frame.players)
+        {
+                if (player.id == my_player_id_)
+                        player.score += static_cast<uint32_t>(predicted_pickups_.size());
+        }
+
+        frame.my_id     = my_player_id_;
+        frame.connected = connected_;
+        frame.ping_ms   = ping_ms_;
+        frame.frame     = ++frames_published_;
+        frames_.publish();
+}
+
+void GameClient::interpolate(float dt)
+{
         // If we have server snapshots, use them to interpolate remote players
-        if (!snapshot_buffer.empty())
+        if (!snapshot_history_.empty())
         {
-                // Use the latest server timestamp as reference
-                uint64_t latest_ts = snapshot_buffer.back().server_ts_ms;
-                uint64_t target_ts = (latest_ts > static_cast<uint64_t>(INTERP_DELAY.count()))
-                                         ? (latest_ts - static_cast<uint64_t>(INTERP_DELAY.count()))
-                                         : latest_ts;
+                size_t frames      = snapshot_history_.size();
+                uint64_t latest_ts = snapshot_history_.timestamp(frames - 1);
+                uint64_t target_ts = render_time_ms(latest_ts, dt);
+
+                frames_rendered_++;
+                if (target_ts > latest_ts)
+                        frames_extrapolated_++;
+
+                // The bracketing snapshots s0, s1 are the same for every player: find them once
+                size_t b      = snapshot_history_.bracket(target_ts);
+                double t      = 0.0;
+                double span_s = 0.0;
+                if (b < frames)
+                {
+                        double span = double(snapshot_history_.timestamp(b + 1) - snapshot_history_.timestamp(b));
+                        t           = (span > 0.0) ? double(target_ts - snapshot_history_.timestamp(b)) / span : 0.0;
+                        span_s      = span / 1000.0;
+                }
+
+                // Dead reckoning past the newest snapshot, bounded so a lost player does not drift away
+                double ahead_s = double(target_ts > latest_ts ? (target_ts - latest_ts) : 0) / 1000.0;
+                ahead_s        = std::min(ahead_s, MAX_DEAD_RECKONING_S);
+
+                // players_ and every snapshot are sorted by id, so one forward pass locates each player
+                SnapshotHistory::Cursor s0   = snapshot_history_.cursor(b);
+                SnapshotHistory::Cursor s1   = snapshot_history_.cursor(b + 1);
+                SnapshotHistory::Cursor last = snapshot_history_.cursor(frames - 1);
 
                 // For each remote player, interpolate/extrapolate based on snapshots
-                for (auto& [id, player] : players_)
+                for (InterpolatedPlayer& player : players_)
                 {
                         // Local player handled by prediction/reconciliation; skip snapshot interpolation
+                        uint32_t id = player.id;
                         if (id == my_player_id_)
                                 continue;
 
-                        // Find two snapshots s0, s1 that bracket target_ts
-                        Snapshot* s0 = nullptr;
-                        Snapshot* s1 = nullptr;
-                        for (size_t i = 0; i + 1 < snapshot_buffer.size(); ++i)
-                        {
-                                if (snapshot_buffer[i].server_ts_ms <= target_ts &&
-                                    snapshot_buffer[i + 1].server_ts_ms >= target_ts)
-                                {
-                                        s0 = &snapshot_buffer[i];
-                                        s1 = &snapshot_buffer[i + 1];
-                                        break;
-                                }
-                        }
-
-                        if (s0 && s1)
+                        // Both snapshots contain positions for this player?
+                        const SnapshotHistory::Entry* e0 = s0.seek(id);
+                        const SnapshotHistory::Entry* e1 = s1.seek(id);
+                        if (e0 && e1)
                         {
-                                // Both snapshots contain positions for this player?
-                                auto it0 = s0->player_positions.find(id);
-                                auto it1 = s1->player_positions.find(id);
-                                if (it0 != s0->player_positions.end() && it1 != s1->player_positions.end())
-                                {
-                                        double span = double(s1->server_ts_ms - s0->server_ts_ms);
-                                        double t    = (span > 0.0) ? double(target_ts - s0->server_ts_ms) / span : 0.0;
-                                        // Lerp positions
-                                        player.render_pos.x = static_cast<float>(it0->second.x +
-                                                                                 (it1->second.x - it0->second.x) * t);
-                                        player.render_pos.y = static_cast<float>(it0->second.y +
-                                                                                 (it1->second.y - it0->second.y) * t);
-                                        continue;
-                                }
+                                // Follow the server's velocities through the span, not a straight line
+                                player.render_pos = hermite(*e0, *e1, t, span_s);
+                                continue;
                         }
 
-                        // If we couldn't bracket, try extrapolation from last two snapshots
-                        if (snapshot_buffer.size() >= 2)
+                        // If we couldn't bracket, dead-reckon from the newest snapshot's velocity
+                        if (const SnapshotHistory::Entry* e_last = last.seek(id))
                         {
-                                const Snapshot& last = snapshot_buffer.back();
-                                const Snapshot& prev = snapshot_buffer[snapshot_buffer.size() - 2];
-                                auto itLast          = last.player_positions.find(id);
-                                auto itPrev          = prev.player_positions.find(id);
-                                if (itLast != last.player_positions.end() && itPrev != prev.player_positions.end())
-                                {
-                                        double dt_sec = double(last.server_ts_ms - prev.server_ts_ms) / 1000.0;
-                                        if (dt_sec > 0.0)
-                                        {
-                                                float vx = (itLast->second.x - itPrev->second.x) /
-                                                           static_cast<float>(dt_sec);
-                                                float vy = (itLast->second.y - itPrev->second.y) /
-                                                           static_cast<float>(dt_sec);
-                                                double extra_ms     = double(target_ts > last.server_ts_ms
-                                                                                 ? (target_ts - last.server_ts_ms)
-                                                                                 : 0);
-                                                double extra_s      = extra_ms / 1000.0;
-                                                player.render_pos.x = itLast->second.x +
-                                                                      vx * static_cast<float>(extra_s);
-                                                player.render_pos.y = itLast->second.y +
-                                                                      vy * static_cast<float>(extra_s);
-                                                continue;
-                                        }
-                                }
+                                player.render_pos = dead_reckon(*e_last, ahead_s);
+                                continue;
                         }
 
                         // Fallback: use target_pos with light smoothing to avoid snapping
@@ -178,12 +479,7 @@ void GameClient::update_interpolation(float dt)
                 }
 
                 // Trim old snapshots (keep ~1s of history)
-                uint64_t keep_ms = 1000;
-                while (snapshot_buffer.size() > 1 &&
-                       (snapshot_buffer.back().server_ts_ms - snapshot_buffer.front().server_ts_ms) > keep_ms)
-                {
-                        snapshot_buffer.pop_front();
-                }
+                snapshot_history_.trim(1000);
                 return;
         }
 
@@ -193,11 +489,11 @@ void GameClient::update_interpolation(float dt)
                 const float SMOOTHING_K_REMOTE = 6.0f;   // higher => faster catch-up for remote players
                 const float SMOOTHING_K_LOCAL  = 10.0f;  // local reconciliation smoothing
 
-                for (auto& [id, player] : players_)
+                for (InterpolatedPlayer& player : players_)
                 {
                         if (dt <= 0.0f)
                                 continue;
-                        float k              = (id == my_player_id_) ? SMOOTHING_K_LOCAL : SMOOTHING_K_REMOTE;
+                        float k              = (player.id == my_player_id_) ? SMOOTHING_K_LOCAL : SMOOTHING_K_REMOTE;
                         float alpha          = 1.0f - std::exp(-k * dt);
                         float dx             = player.target_pos.x - player.render_pos.x;
                         float dy             = player.target_pos.y - player.render_pos.y;
@@ -207,6 +503,32 @@ void GameClient::update_interpolation(float dt)
         }
 }
 
+uint64_t GameClient::render_time_ms(uint64_t latest_ts, float dt)
+{
+        uint64_t target_ts;
+        if (clock_sync_.synced() && jitter_buffer_.ready())
+        {
+                // Render at a precise server time: now on the server clock, minus a delay sized from how late
+                // snapshots have been arriving
+                int64_t server_now_ms = clock_sync_.server_time_us(static_cast<int64_t>(steady_now_us())) / 1000;
+                auto delay_ms         = static_cast<int64_t>(std::lround(jitter_buffer_.advance(dt * 1000.0)));
+                auto stamp_ms         = static_cast<uint32_t>(server_now_ms - delay_ms);  // Snapshot stamp width
+                target_ts             = unwrap_stamp(stamp_ms, latest_ts);
+        }
+        else
+        {
+                // No measurements yet: trail the newest snapshot by a fixed delay
+                target_ts = (latest_ts > static_cast<uint64_t>(INTERP_DELAY.count()))
+                                ? (latest_ts - static_cast<uint64_t>(INTERP_DELAY.count()))
+                                : latest_ts;
+        }
+
+        // Clock corrections must not make remote players step backwards
+        target_ts       = std::max(target_ts, last_render_ts_);
+        last_render_ts_ = target_ts;
+        return target_ts;
+}
+
 void GameClient::read_header()
 {
         asio::async_read(socket_,
@@ -217,6 +539,7 @@ void GameClient::read_header()
                                  {
                                          protocol::MessageHeader header;
                                          std::memcpy(&header, header_buffer_.data(), sizeof(header));
+                                         bytes_received_ += sizeof(header);
 
                                          if (header.length > sizeof(protocol::MessageHeader) && header.length < 65536)
                                          {
@@ -230,10 +553,7 @@ void GameClient::read_header()
                                  else
                                  {
                                          std::cout << "Connection lost: " << ec.message() << "\n";
-                                         {
-                                                 std::lock_guard<std::mutex> lock(mutex_);
-                                                 connected_ = false;
-                                         }
+                                         connected_ = false;
                                  }
                          });
 }
@@ -248,23 +568,49 @@ void GameClient::read_body(uint32_t length)
                          {
                                  if (!ec)
                                  {
-                                         std::vector<uint8_t> full_msg;
-                                         full_msg.insert(full_msg.end(), header_buffer_.begin(), header_buffer_.end());
-                                         full_msg.insert(full_msg.end(), body_buffer_.begin(), body_buffer_.end());
-
-                                         // process immediately — server simulates latency
-                                         process_message(full_msg);
-                                         read_header();
+                                         bytes_received_ += body_buffer_.size();
+                                         messages_received_++;
+                                         body_received_at_ = std::chrono::steady_clock::now();
+                                         deliver_message();
                                  }
                                  else
                                  {
-                                         std::lock_guard<std::mutex> lock(mutex_);
                                          connected_ = false;
                                  }
                          });
 }
 
+void GameClient::deliver_message()
+{
+        // A full inbox means the simulation stage is behind: stop reading and let TCP push back on the server
+        InboundMessage* msg = inbox_.claim();
+        if (!msg)
+        {
+                inbox_retry_timer_.expires_after(std::chrono::milliseconds(1));
+                inbox_retry_timer_.async_wait(
+                    [this](asio::error_code ec)
+                    {
+                            if (!ec)
+                                    deliver_message();
+                    });
+                return;
+        }
+
+        // Slots keep their capacity, so steady-state framing does not allocate
+        msg->data.assign(header_buffer_.begin(), header_buffer_.end());
+        msg->data.insert(msg->data.end(), body_buffer_.begin(), body_buffer_.end());
+        msg->received = body_received_at_;
+        inbox_.publish();
+        read_header();
+}
+
 void GameClient::process_message(const std::vector<uint8_t>& data)
+{
+        std::lock_guard<std::mutex> lock(mutex_);
+        apply_message(data, std::chrono::steady_clock::now());
+}
+
+void GameClient::apply_message(const std::vector<uint8_t>& data, std::chrono::steady_clock::time_point received)
 {
         protocol::MessageReader reader(data.data(), data.size());
         protocol::MessageHeader header;
@@ -275,7 +621,7 @@ void GameClient::process_message(const std::vector<uint8_t>& data)
         switch (header.type)
         {
         case protocol::MessageType::SERVER_GAME_STATE:
-                handle_game_state(reader);
+                handle_game_state(reader, received);
                 break;
 
         case protocol::MessageType::SERVER_START_GAME:
@@ -283,24 +629,37 @@ void GameClient::process_message(const std::vector<uint8_t>& data)
                 uint32_t assigned_id = 0;
                 if (reader.read_uint32(assigned_id))
                 {
-                        {
-                                std::lock_guard<std::mutex> lock(mutex_);
-                                my_player_id_ = assigned_id;
-                        }
+                        my_player_id_ = assigned_id;
                         std::cout << "Assigned player ID: " << assigned_id << "\n";
                 }
                 break;
         }
 
+        case protocol::MessageType::SERVER_TIME_RESPONSE:
+        {
+                protocol::TimeSyncMessage sync;
+                if (reader.read_uint64(sync.client_send_us) && reader.read_uint64(sync.server_receive_us) &&
+                    reader.read_uint64(sync.server_send_us))
+                {
+                        int64_t received_us = static_cast<int64_t>(to_us(received));
+                        clock_sync_.add_sample(static_cast<int64_t>(sync.client_send_us),
+                                               static_cast<int64_t>(sync.server_receive_us),
+                                               static_cast<int64_t>(sync.server_send_us),
+                                               received_us);
+                }
+                break;
+        }
+
         default:
                 break;
         }
 }
 
-void GameClient::handle_game_state(protocol::MessageReader& reader)
+void GameClient::handle_game_state(protocol::MessageReader& reader, std::chrono::steady_clock::time_point received)
 {
         uint32_t timestamp;
-        if (!reader.read_uint32(timestamp))
+        uint32_t tick;
+        if (!reader.read_uint32(timestamp) || !reader.read_uint32(tick))
                 return;
 
         uint8_t player_count = 0, coin_count = 0;
@@ -309,12 +668,39 @@ void GameClient::handle_game_state(protocol::MessageReader& reader)
         player_count = reader.data[reader.offset++];
         coin_count   = reader.data[reader.offset++];
 
-        auto now     = std::chrono::steady_clock::now();
+        auto now     = received;  // Stamped by the network stage: intervals exclude time spent in the inbox
 
-        std::lock_guard<std::mutex> lock(mutex_);
+        last_snapshot_tick_ = tick;
+
+        // Unwrapped once here, so the history, the jitter buffer and the render clock compare plain 64-bit times
+        uint64_t server_ts = snapshots_received_ > 0 ? unwrap_stamp(timestamp, last_server_ts_) : timestamp;
+        last_server_ts_    = server_ts;
+
+        // Snapshot age once usable, on the server clock, sizes the interpolation delay. Measured when the
+        // simulation stage applies it, so the delay also covers the wait in the inbox.
+        if (clock_sync_.synced())
+        {
+                int64_t server_now_us = clock_sync_.server_time_us(static_cast<int64_t>(steady_now_us()));
+                auto stamp_now_ms     = static_cast<uint32_t>(server_now_us / 1000);  // Snapshot stamp width
+                jitter_buffer_.add_snapshot(server_ts, static_cast<int32_t>(stamp_now_ms - timestamp));
+        }
+
+        // Snapshot inter-arrival statistics
+        if (snapshots_received_ > 0)
+        {
+                double interval = std::chrono::duration<double, std::milli>(now - last_snapshot_at_).count();
+                interval_sum_ms_    += interval;
+                interval_sq_sum_ms_ += interval * interval;
+                interval_max_ms_     = std::max(interval_max_ms_, interval);
+                latency_.snapshot_interval_us.record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(now - last_snapshot_at_).count()));
+        }
+        snapshots_received_++;
+        last_snapshot_at_ = now;
 
         // Update players
-        std::map<uint32_t, InterpolatedPlayer> new_players;
+        // Rebuilt in next_players_ (reused storage), then swapped in
+        next_players_.clear();
         auto dist = [](const protocol::Vec2& a, const protocol::Vec2& b)
         {
                 float dx = a.x - b.x;
@@ -324,9 +710,10 @@ void GameClient::handle_game_state(protocol::MessageReader& reader)
 
         uint32_t server_last_seq_for_me = 0;
         uint32_t server_last_ts_for_me  = 0;
+        uint32_t server_score_for_me    = server_score_;
+        protocol::Vec2 server_pos_for_me;
 
-        Snapshot snap;
-        snap.server_ts_ms = timestamp;
+        snapshot_history_.begin(server_ts);
 
         for (int i = 0; i < player_count; i++)
         {
@@ -338,73 +725,45 @@ void GameClient::handle_game_state(protocol::MessageReader& reader)
                 {
                         server_last_seq_for_me = ps.last_processed_input_seq;
                         server_last_ts_for_me  = ps.last_processed_input_ts;
+                        server_pos_for_me      = ps.position;
+                        server_score_for_me    = ps.score;
                 }
 
-                auto it = players_.find(ps.id);
-                if (it != players_.end())
+                InterpolatedPlayer& next = next_players_.emplace_back();
+                if (const InterpolatedPlayer* found = find_player(ps.id))
                 {
                         // Existing player - decide how to interpolate / reconcile
-                        const InterpolatedPlayer& prev = it->second;
+                        const InterpolatedPlayer& prev = *found;
 
                         // Distance from server position to what we are currently rendering
-                        float server_to_render      = dist(ps.position, prev.render_pos);
-                        float server_to_prev_target = dist(ps.position, prev.target_pos);
+                        float server_to_render = dist(ps.position, prev.render_pos);
 
                         // Small deadzone to ignore micro-corrections that cause jitter
-                        const float DEADZONE         = 1.0f;    // pixels
-                        const float RECONCILE_SNAP   = 100.0f;  // if off by this much, snap
-                        const float RECONCILE_SMOOTH = 5.0f;    // if off by this much, smooth-correct
+                        const float DEADZONE = 1.0f;  // pixels
 
                         if (ps.id == my_player_id_)
                         {
-                                // Local player: reconcile predicted position with authoritative server
-                                float pred_diff = dist(ps.position, prev.current_pos);
-
-                                if (pred_diff > RECONCILE_SNAP)
-                                {
-                                        // Way out of sync: snap to server position
-                                        InterpolatedPlayer ip;
-                                        ip.id              = ps.id;
-                                        ip.current_pos     = ps.position;
-                                        ip.target_pos      = ps.position;
-                                        ip.render_pos      = ps.position;
-                                        ip.score           = ps.score;
-                                        ip.last_update     = now;
-                                        new_players[ps.id] = ip;
-                                }
-                                else if (pred_diff > RECONCILE_SMOOTH)
-                                {
-                                        // Moderate desync: smoothly correct by interpolating towards server
-                                        new_players[ps.id]             = prev;
-                                        new_players[ps.id].current_pos = prev.render_pos;
-                                        new_players[ps.id].target_pos  = ps.position;
-                                        new_players[ps.id].score       = ps.score;
-                                        new_players[ps.id].last_update = now;
-                                }
-                                else
-                                {
-                                        // Small or no desync: keep predicted position but nudge target
-                                        new_players[ps.id]             = prev;
-                                        new_players[ps.id].target_pos  = ps.position;
-                                        new_players[ps.id].score       = ps.score;
-                                        new_players[ps.id].last_update = now;
-                                }
+                                // Local player: keep the prediction; reconciliation below replays the
+                                // unacknowledged inputs on top of the server position
+                                next             = prev;
+                                next.score       = ps.score;
+                                next.last_update = now;
                         }
                         else
                         {
                                 // Remote player: ignore tiny corrections to avoid buzzing
                                 if (server_to_render < DEADZONE)
                                 {
-                                        new_players[ps.id]       = prev;
-                                        new_players[ps.id].score = ps.score;
+                                        next       = prev;
+                                        next.score = ps.score;
                                 }
                                 else
                                 {
-                                        new_players[ps.id]             = prev;
-                                        new_players[ps.id].current_pos = prev.render_pos;
-                                        new_players[ps.id].target_pos  = ps.position;
-                                        new_players[ps.id].score       = ps.score;
-                                        new_players[ps.id].last_update = now;
+                                        next             = prev;
+                                        next.current_pos = prev.render_pos;
+                                        next.target_pos  = ps.position;
+                                        next.score       = ps.score;
+                                        next.last_update = now;
                                 }
                         }
                 }
@@ -418,18 +777,18 @@ void GameClient::handle_game_state(protocol::MessageReader& reader)
                         ip.render_pos      = ps.position;
                         ip.score           = ps.score;
                         ip.last_update     = now;
-                        new_players[ps.id] = ip;
+                        next               = ip;
                 }
 
                 // fill snapshot
-                snap.player_positions[ps.id] = ps.position;
-                snap.player_scores[ps.id]    = ps.score;
-                snap.player_last_seq[ps.id]  = ps.last_processed_input_seq;
+                snapshot_history_.add(ps.id, ps.position, ps.velocity);
         }
-        players_ = std::move(new_players);
+        if (!std::is_sorted(next_players_.begin(), next_players_.end(), by_id))
+                std::sort(next_players_.begin(), next_players_.end(), by_id);
+        players_.swap(next_players_);
 
-        // push snapshot into buffer
-        snapshot_buffer.push_back(std::move(snap));
+        // commit snapshot into history (sorted by id for interpolation)
+        snapshot_history_.commit();
 
         // Reconciliation for local player: measure ping, drop acknowledged inputs and reapply pending ones
         if (my_player_id_ != 0 && server_last_seq_for_me != 0)
@@ -439,9 +798,14 @@ void GameClient::handle_game_state(protocol::MessageReader& reader)
                                                             std::chrono::steady_clock::now().time_since_epoch())
                                                             .count());
 
+                // Only a newly acknowledged input gives a fresh round-trip sample; repeats would inflate the tail
+                bool new_ack = !pending_inputs_.empty() && pending_inputs_.front().seq <= server_last_seq_for_me;
+
                 if (server_last_ts_for_me != 0)
                 {
                         uint32_t rtt = (now_ms >= server_last_ts_for_me) ? (now_ms - server_last_ts_for_me) : 0;
+                        if (new_ack)
+                                latency_.input_rtt_ms.record(rtt);
                         if (ping_ms_ <= 0.0f)
                                 ping_ms_ = static_cast<float>(rtt);
                         else
@@ -456,6 +820,7 @@ void GameClient::handle_game_state(protocol::MessageReader& reader)
                                 if (pi.seq == ack_seq)
                                 {
                                         uint32_t rtt = (now_ms >= pi.timestamp) ? (now_ms - pi.timestamp) : 0;
+                                        latency_.input_rtt_ms.record(rtt);
                                         if (ping_ms_ <= 0.0f)
                                                 ping_ms_ = static_cast<float>(rtt);
                                         else
@@ -470,35 +835,17 @@ void GameClient::handle_game_state(protocol::MessageReader& reader)
                 while (!pending_inputs_.empty() && pending_inputs_.front().seq <= server_last_seq_for_me)
                         pending_inputs_.pop_front();
 
-                auto it = players_.find(my_player_id_);
-                if (it != players_.end())
+                if (InterpolatedPlayer* me = find_player(my_player_id_))
                 {
-                        const float INPUT_DT     = 0.016f;  // assume ~60fps
-                        const float PLAYER_SPEED = 150.0f;
-
-                        protocol::Vec2 recon_pos = it->second.current_pos;
-                        for (size_t i = 0; i < pending_inputs_.size(); ++i)
-                        {
-                                const auto& pi = pending_inputs_[i];
-                                float dt       = 0.016f;
-                                if (i + 1 < pending_inputs_.size())
-                                        dt = (pending_inputs_[i + 1].timestamp - pi.timestamp) / 1000.0f;
-                                else
-                                        dt = 1.0f / 60.0f;  // fallback
-
-                                float len = std::sqrt(pi.dx * pi.dx + pi.dy * pi.dy);
-                                if (len > 0.001f)
-                                {
-                                        float nx     = pi.dx / len;
-                                        float ny     = pi.dy / len;
-                                        recon_pos.x += nx * PLAYER_SPEED * dt;
-                                        recon_pos.y += ny * PLAYER_SPEED * dt;
-                                }
-                        }
-
-                        it->second.current_pos = recon_pos;
-                        it->second.render_pos  = recon_pos;
-                        it->second.target_pos  = recon_pos;
+                        // Start from the server's position after the acknowledged input and replay the rest,
+                        // one server tick each. Unless inputs were lost this reproduces the prediction exactly.
+                        protocol::Vec2 recon_pos = server_pos_for_me;
+                        for (const PendingInput& pi : pending_inputs_)
+                                movement::step(recon_pos.x, recon_pos.y, pi.dx, pi.dy);
+
+                        me->current_pos = recon_pos;
+                        me->render_pos  = recon_pos;
+                        me->target_pos  = recon_pos;
                 }
         }
 
@@ -509,25 +856,43 @@ void GameClient::handle_game_state(protocol::MessageReader& reader)
                 protocol::CoinState cs;
                 if (!reader.read_coin_state(cs))
                         break;
-                coins_[cs.id] = cs;
+                coins_.push_back(cs);
         }
+        resolve_pickups(server_last_seq_for_me, server_score_for_me);
+}
+
+InterpolatedPlayer* GameClient::find_player(uint32_t id)
+{
+        auto it = std::lower_bound(players_.begin(),
+                                   players_.end(),
+                                   id,
+                                   [](const InterpolatedPlayer& p, uint32_t key) { return p.id < key; });
+        return it != players_.end() && it->id == id ? &*it : nullptr;
 }
 
 std::map<uint32_t, InterpolatedPlayer> GameClient::get_players() const
 {
         std::lock_guard<std::mutex> lock(mutex_);
-        return players_;
+        std::map<uint32_t, InterpolatedPlayer> players;
+        for (const InterpolatedPlayer& player : players_)
+                players.emplace(player.id, player);
+        return players;
 }
 
 std::map<uint32_t, protocol::CoinState> GameClient::get_coins() const
 {
         std::lock_guard<std::mutex> lock(mutex_);
-        return coins_;
+        std::map<uint32_t, protocol::CoinState> coins;
+        for (const protocol::CoinState& coin : coins_)
+        {
+                if (!pickup_predicted(coin.id))
+                        coins.emplace(coin.id, coin);
+        }
+        return coins;
 }
 
 bool GameClient::is_connected() const
 {
-        std::lock_guard<std::mutex> lock(mutex_);
         return connected_;
 }
 
@@ -541,4 +906,45 @@ float GameClient::get_ping_ms() const
 {
         std::lock_guard<std::mutex> lock(mutex_);
         return ping_ms_;
+}
+
+NetStats GameClient::get_net_stats() const
+{
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        NetStats stats;
+        stats.bytes_received     = bytes_received_;
+        stats.messages_received  = messages_received_;
+        stats.snapshots_received = snapshots_received_;
+        stats.interval_max_ms    = interval_max_ms_;
+        stats.ping_ms            = ping_ms_;
+
+        if (clock_sync_.synced())
+        {
+                stats.clock_offset_ms = clock_sync_.offset_us(static_cast<int64_t>(steady_now_us())) / 1000.0;
+                stats.clock_drift_ppm = clock_sync_.drift_ppm();
+                stats.clock_rtt_ms    = static_cast<double>(clock_sync_.delay_us()) / 1000.0;
+        }
+        stats.interp_delay_ms     = jitter_buffer_.ready() ? jitter_buffer_.delay_ms() : double(INTERP_DELAY.count());
+        stats.interp_target_ms    = jitter_buffer_.target_ms();
+        stats.arrival_jitter_ms   = jitter_buffer_.jitter_ms();
+        stats.frames_rendered     = frames_rendered_;
+        stats.frames_extrapolated = frames_extrapolated_;
+        stats.pickups_predicted   = pickups_predicted_;
+        stats.pickups_rolled_back = pickups_rolled_back_;
+
+        if (snapshots_received_ > 1)
+        {
+                double n                 = static_cast<double>(snapshots_received_ - 1);
+                stats.interval_mean_ms   = interval_sum_ms_ / n;
+                double variance          = interval_sq_sum_ms_ / n - stats.interval_mean_ms * stats.interval_mean_ms;
+                stats.interval_jitter_ms = variance > 0.0 ? std::sqrt(variance) : 0.0;
+        }
+        return stats;
+}
+
+LatencyHistograms GameClient::get_latency_histograms() const
+{
+        std::lock_guard<std::mutex> lock(mutex_);
+        return latency_;
 }
\ No newline at end of file
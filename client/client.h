@@ -7,14 +7,22 @@
 
 #pragma once
 #include "protocol.h"
+#include "movement.h"
+#include "histogram.h"
+#include "triple_buffer.h"
+#include "spsc_queue.h"
+#include "snapshot_history.h"
+#include "clock_sync.h"
+#include "jitter_buffer.h"
 #include <asio.hpp>
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <chrono>
 #include <deque>
-#include <unordered_map>
 #include <map>
 #include <mutex>
+#include <thread>
 
 using asio::ip::tcp;
 
@@ -32,6 +40,68 @@ struct InterpolatedPlayer
         std::chrono::steady_clock::time_point last_update;  ///< Last update timestamp
 };
 
+/**
+ * @struct RenderFrame
+ * @brief Immutable, flat copy of everything the renderer draws in one frame
+ */
+struct RenderFrame
+{
+        /**
+         * @struct Player
+         * @brief Interpolated player as drawn
+         */
+        struct Player
+        {
+                uint32_t id;
+                protocol::Vec2 position;  ///< Interpolated / predicted render position
+                uint32_t score;
+        };
+
+        std::vector<Player> players;      ///< Sorted by id
+        std::vector<protocol::Vec2> coins;
+        uint32_t my_id = 0;               ///< Local player ID, 0 until assigned
+        bool connected = false;
+        float ping_ms  = 0.0f;
+        uint64_t frame = 0;               ///< Publish counter (0 = nothing published yet)
+};
+
+/**
+ * @struct NetStats
+ * @brief Traffic and timing counters for one connection
+ */
+struct NetStats
+{
+        uint64_t bytes_received      = 0;     ///< Bytes read from the socket (headers included)
+        uint64_t messages_received   = 0;     ///< Complete messages read
+        uint64_t snapshots_received  = 0;     ///< SERVER_GAME_STATE messages handled
+        double interval_mean_ms      = 0.0;   ///< Mean time between snapshot arrivals
+        double interval_jitter_ms    = 0.0;   ///< Standard deviation of the time between snapshot arrivals
+        double interval_max_ms       = 0.0;   ///< Longest gap between snapshot arrivals
+        float ping_ms                = 0.0f;  ///< Smoothed round-trip time
+        double clock_offset_ms       = 0.0;   ///< Server clock minus client clock (0 until synced)
+        double clock_drift_ppm       = 0.0;   ///< Server clock rate relative to the client clock
+        double clock_rtt_ms          = 0.0;   ///< Round trip of the clock exchange currently trusted
+        double interp_delay_ms       = 0.0;   ///< Interpolation delay in use (adaptive once the clock is synced)
+        double interp_target_ms      = 0.0;   ///< Delay the measured snapshot arrivals call for
+        double arrival_jitter_ms     = 0.0;   ///< Standard deviation of snapshot age at arrival
+        uint64_t frames_rendered     = 0;     ///< Interpolation updates with snapshots available
+        uint64_t frames_extrapolated = 0;     ///< Of those, updates whose render time was past the newest snapshot
+        uint64_t pickups_predicted   = 0;     ///< Coin pickups shown before the server confirmed them
+        uint64_t pickups_rolled_back = 0;     ///< Predicted pickups the server did not make
+};
+
+/**
+ * @struct LatencyHistograms
+ * @brief Full latency distributions for one connection (percentiles, not just averages)
+ */
+struct LatencyHistograms
+{
+        Histogram input_rtt_ms;          ///< Input sent -> acknowledged in a snapshot
+        Histogram snapshot_interval_us;  ///< Time between snapshot arrivals
+        Histogram inbox_wait_us;         ///< Message framed by the network thread -> applied by the simulation stage
+        Histogram step_us;               ///< Duration of one simulation stage step()
+};
+
 /**
  * @class GameClient
  * @brief Manages client-side networking, state interpolation, and server communication
@@ -42,6 +112,14 @@ struct InterpolatedPlayer
  * - Entity interpolation for smooth visuals
  * - Input reconciliation with server state
  * - Thread-safe state access
+ *
+ * Work is split into three stages that only meet at lock-free handoffs:
+ * - Network (the io_context thread): frames incoming bytes into messages and pushes them to an SPSC
+ *   inbox; writes outgoing messages. It never decodes game state or takes mutex_.
+ * - Simulation (step(), normally on the thread started by start_simulation()): applies queued messages,
+ *   samples, predicts and batches input, reconciles, interpolates, and publishes a RenderFrame. Input
+ *   batches go back to the network stage through an SPSC outbox.
+ * - Render: reads the newest RenderFrame from a triple buffer (acquire_render_frame()).
  */
 class GameClient
 {
@@ -60,26 +138,52 @@ public:
         void connect(const std::string& host, uint16_t port);
 
         /**
-         * @brief Send player input to server
+         * @brief Set the direction currently held by the player (thread-safe)
          * @param dx X direction (-1 to 1)
-         * @param dy Y direction (-1 to 1)
+         * @param dy Y direction (-1 to 1); (0, 0) stops
+         * @note Does not send anything and never blocks. The simulation stage samples the held direction
+         *       once per server tick (INPUT_RATE), predicts it locally and sends the commands in batches,
+         *       so the upload rate does not depend on how often this is called.
          */
-        void send_input(float dx, float dy);
+        void set_input(float dx, float dy);
 
         /**
-         * @brief Apply local prediction immediately for responsive movement
-         * @param dx X direction (-1 to 1)
-         * @param dy Y direction (-1 to 1)
-         * @param dt Delta time since last frame
+         * @brief Run the simulation stage on its own thread, stepping at INPUT_RATE
+         * @note Call once after connect(); stopped by stop_simulation() or the destructor
+         */
+        void start_simulation();
+
+        /**
+         * @brief Stop and join the simulation thread (no-op if it is not running)
          */
-        void apply_local_input(float dx, float dy, float dt);
+        void stop_simulation();
+
+        ~GameClient();
 
         /**
-         * @brief Update entity interpolation for smooth rendering
+         * @brief Run one simulation stage step
+         * @param dt Time since the previous step
+         * @note Applies every message the network stage queued, samples the input commands that are due,
+         *       then interpolates and publishes a RenderFrame. Must always be called from the same thread
+         *       (the SPSC consumer); tools that drive the client from their own loop call it directly
+         *       instead of start_simulation().
+         */
+        void step(float dt);
+
+        /**
+         * @brief Update entity interpolation for smooth rendering and publish a RenderFrame
          * @param dt Delta time since last frame
+         * @note Simulation stage; step() includes this
          */
         void update_interpolation(float dt);
 
+        /**
+         * @brief Get the latest frame published by the simulation stage without locking or copying
+         * @return Frame, valid until the next call
+         * @note Render thread only (single reader)
+         */
+        const RenderFrame& acquire_render_frame() { return frames_.read(); }
+
         /**
          * @brief Get all players (thread-safe copy)
          * @return Map of player ID to interpolated player state
@@ -104,21 +208,124 @@ public:
          */
         uint32_t get_my_id() const;
 
+        /**
+         * @brief Decode and apply one complete server message
+         * @param data Message bytes, header included
+         * @note Simulation stage (step() calls it for each queued message); public so tools can feed
+         *       recorded or synthetic traffic
+         */
+        void process_message(const std::vector<uint8_t>& data);
+
+        /**
+         * @brief Get traffic and snapshot timing counters (thread-safe copy)
+         * @return Connection statistics
+         */
+        NetStats get_net_stats() const;
+
+        /**
+         * @brief Get input round-trip and snapshot inter-arrival histograms (thread-safe copy)
+         * @return Latency histograms
+         */
+        LatencyHistograms get_latency_histograms() const;
+
 private:
+        /**
+         * @struct InboundMessage
+         * @brief One framed server message on its way from the network stage to the simulation stage
+         */
+        struct InboundMessage
+        {
+                std::vector<uint8_t> data;                      ///< Header and body (slot keeps its capacity)
+                std::chrono::steady_clock::time_point received;  ///< When the network thread finished reading it
+        };
+
+        // Network stage
         void read_header();
         void read_body(uint32_t length);
-        void process_message(const std::vector<uint8_t>& data);
-        void handle_game_state(protocol::MessageReader& reader);
+        void deliver_message();  ///< Push the message just read to inbox_, or wait for the simulation stage
+        void send_queued();      ///< Move outbox_queue_ messages onto the socket
+        void queue_message(const protocol::MessageBuffer& msg);
+        void start_write();
+        void schedule_time_sync();
+        void send_time_request();
+
+        // Simulation stage (all require mutex_)
+        void apply_message(const std::vector<uint8_t>& data, std::chrono::steady_clock::time_point received);
+        void handle_game_state(protocol::MessageReader& reader, std::chrono::steady_clock::time_point received);
+        void interpolate(float dt);
+        void publish_render_frame();
+        void sample_input();
+        void flush_inputs();
+        void simulation_loop();
+
+        /**
+         * @brief Pick the server time (unwrapped ms, see last_server_ts_) to render remote players at
+         * @param latest_ts Timestamp of the newest snapshot (fallback before the clock is synced)
+         * @param dt Playback time since the previous call (eases the adaptive delay)
+         * @return Render time, never earlier than the previous one
+         * @note Requires mutex_
+         */
+        uint64_t render_time_ms(uint64_t latest_ts, float dt);
+
+        /**
+         * @brief Move the local player by one input command, as the server will (movement::step), and
+         *        predict the coins that move picks up
+         * @param seq Input sequence number of the command
+         * @param dx X direction
+         * @param dy Y direction
+         * @note Requires mutex_
+         */
+        void predict(uint32_t seq, float dx, float dy);
+
+        /**
+         * @brief Confirm or roll back predicted pickups against a new snapshot
+         * @param acked_seq Last input the server applied for the local player
+         * @param score Local player's score in the snapshot
+         * @note Requires mutex_; call after coins_ holds the snapshot's coins
+         */
+        void resolve_pickups(uint32_t acked_seq, uint32_t score);
+
+        /**
+         * @brief Check whether a coin is hidden by a pending predicted pickup
+         * @param coin_id Coin ID
+         * @note Requires mutex_
+         */
+        bool pickup_predicted(uint32_t coin_id) const;
+
+        /**
+         * @brief Find a player by ID (binary search over players_)
+         * @param id Player ID
+         * @return Player, or nullptr if not in the latest snapshot
+         * @note Requires mutex_; the pointer is invalidated by the next snapshot
+         */
+        InterpolatedPlayer* find_player(uint32_t id);
 
         asio::io_context& io_;
         tcp::socket socket_;
-        asio::steady_timer latency_timer_;
+        asio::steady_timer inbox_retry_timer_;  ///< Waits for inbox_ space when the simulation stage falls behind
 
         std::array<uint8_t, sizeof(protocol::MessageHeader)> header_buffer_;
         std::vector<uint8_t> body_buffer_;
 
-        std::map<uint32_t, InterpolatedPlayer> players_;
-        std::map<uint32_t, protocol::CoinState> coins_;
+        // Entity state, rebuilt from each snapshot in reused storage (no steady-state allocation)
+        std::vector<InterpolatedPlayer> players_;       ///< Sorted by id
+        std::vector<InterpolatedPlayer> next_players_;  ///< Scratch for the next snapshot, swapped with players_
+        std::vector<protocol::CoinState> coins_;        ///< In snapshot order
+
+        /**
+         * @struct PredictedPickup
+         * @brief A coin the local player's predicted movement collected, awaiting the server's verdict
+         */
+        struct PredictedPickup
+        {
+                uint32_t coin_id;
+                uint32_t seq;  ///< Input whose movement step touched the coin
+        };
+
+        std::vector<PredictedPickup> predicted_pickups_;  ///< Pending; their coins are hidden and scored
+        uint64_t pickups_predicted_   = 0;
+        uint64_t pickups_rolled_back_ = 0;  ///< The coin survived our input, or went to another player
+        uint32_t server_score_        = 0;  ///< Local player's score in the previous snapshot
 
         struct PendingInput
         {
@@ -128,29 +335,72 @@ private:
         };
 
         std::deque<PendingInput> pending_inputs_;
-        uint32_t next_input_seq_;
+        uint32_t next_input_seq_;  ///< Also the client input tick: one command per INPUT_RATE sample
 
-        /**
-         * @struct Snapshot
-         * @brief Server state snapshot for interpolation
-         */
-        struct Snapshot
-        {
-                uint64_t server_ts_ms;                                          ///< Server timestamp in milliseconds
-                std::unordered_map<uint32_t, protocol::Vec2> player_positions;  ///< Player positions
-                std::unordered_map<uint32_t, uint32_t> player_scores;           ///< Player scores
-                std::unordered_map<uint32_t, uint32_t> player_last_seq;         ///< Last processed input sequence
-        };
+        // Input stream state (simulation stage; held_input_ is written by set_input() from any thread)
+        static constexpr uint32_t INPUT_RATE       = movement::TICK_RATE;  ///< Commands per second, one per server tick
+        static constexpr uint32_t INPUTS_PER_BATCH = 2;                    ///< Commands per write (30 writes/s)
+        static constexpr size_t MAX_BATCH_COMMANDS = 255;                  ///< Wire limit (count is one byte)
+        std::chrono::steady_clock::time_point next_sample_;  ///< Next command due (unset before the first step)
+        std::atomic<uint64_t> held_input_{0};                ///< Held (dx, dy) as two packed float bit patterns
+        uint64_t input_ticks_ = 0;
+        std::vector<PendingInput> unsent_inputs_;  ///< Sampled but not yet written
+
+        // Stage handoffs: framed messages in, finished input batches out (both reuse their slots' buffers)
+        static constexpr size_t INBOX_CAPACITY  = 256;  ///< Over 10s of snapshots at 20Hz
+        static constexpr size_t OUTBOX_CAPACITY = 64;   ///< Over 2s of input batches at 30/s
+        SpscQueue<InboundMessage> inbox_{INBOX_CAPACITY};                   ///< Network -> simulation
+        SpscQueue<protocol::MessageBuffer> outbox_queue_{OUTBOX_CAPACITY};  ///< Simulation -> network
+        std::chrono::steady_clock::time_point body_received_at_;           ///< Network stage scratch
+
+        // Outgoing messages (network thread only): one async_write at a time, reused buffers
+        protocol::MessageBuffer scratch_;  ///< Message being built
+        std::vector<uint8_t> outbox_;      ///< Queued while a write is in flight
+        std::vector<uint8_t> writing_;     ///< Owned by the write in flight
+        bool write_in_flight_ = false;
 
-        std::deque<Snapshot> snapshot_buffer;  ///< Buffer of server snapshots for interpolation
-        const std::chrono::milliseconds INTERP_DELAY = std::chrono::milliseconds(200);  ///< Interpolation delay
+        // Clock sync: NTP-style exchanges, sent by the network stage and filtered by clock_sync_ (mutex_)
+        static constexpr uint32_t SYNC_BURST = 4;  ///< Quick exchanges after connecting
+        static constexpr std::chrono::milliseconds SYNC_BURST_INTERVAL{250};
+        static constexpr std::chrono::milliseconds SYNC_INTERVAL{2000};
+        asio::steady_timer sync_timer_;
+        uint32_t clock_sync_requests_ = 0;
+        ClockSync clock_sync_;
+        uint64_t last_render_ts_ = 0;  ///< Previous render_time_ms() result
+        uint64_t last_server_ts_ = 0;  ///< Newest snapshot stamp, unwrapped onto a 64-bit timeline
 
-        bool connected_;         ///< Connection status
-        uint32_t my_player_id_;  ///< Local player ID assigned by server
+        uint32_t last_snapshot_tick_ = 0;  ///< Server tick of the newest snapshot, echoed in inputs
+
+        SnapshotHistory snapshot_history_;  ///< Recent server snapshots for interpolation
+        const std::chrono::milliseconds INTERP_DELAY = std::chrono::milliseconds(200);  ///< Delay behind the newest
+                                                                                        ///< snapshot until synced
+        static constexpr double MAX_DEAD_RECKONING_S = 0.25;  ///< Longest extrapolation along a snapshot velocity
+        JitterBuffer jitter_buffer_{static_cast<double>(INTERP_DELAY.count())};  ///< Adaptive delay once synced
+        uint64_t frames_rendered_     = 0;
+        uint64_t frames_extrapolated_ = 0;  ///< Render time was past the newest snapshot
+
+        std::atomic<bool> connected_;  ///< Connection status (written by the network stage)
+        uint32_t my_player_id_;        ///< Local player ID assigned by server
 
         float ping_ms_;  ///< Current ping in milliseconds
 
-        mutable std::mutex mutex_;  ///< Mutex protecting shared state between threads
+        // Connection statistics, reported through get_net_stats(); the network stage only touches the atomics
+        std::atomic<uint64_t> bytes_received_{0};
+        std::atomic<uint64_t> messages_received_{0};
+        uint64_t snapshots_received_ = 0;
+        double interval_sum_ms_      = 0.0;  ///< Sum of snapshot inter-arrival times
+        double interval_sq_sum_ms_   = 0.0;  ///< Sum of squared inter-arrival times (for jitter)
+        double interval_max_ms_      = 0.0;
+        std::chrono::steady_clock::time_point last_snapshot_at_;
+        LatencyHistograms latency_;  ///< Per-sample distributions behind ping_ms_ and the interval figures
+
+        mutable std::mutex mutex_;  ///< Held by each simulation step; lets the getters read consistent state
+
+        TripleBuffer<RenderFrame> frames_;  ///< Written by the simulation stage, read by the renderer
+        uint64_t frames_published_ = 0;
+
+        std::thread simulation_thread_;       ///< Started by start_simulation()
+        std::atomic<bool> simulating_{false};
 
 public:
         /**
@@ -0,0 +1,136 @@
+/**
+ * @file clock_sync.h
+ * @brief Filtered estimate of the server clock from NTP-style time exchanges
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class ClockSync
+ * @brief Tracks the offset and drift of the server clock relative to the client clock
+ *
+ * Each exchange yields four timestamps: client send (t0), server receive (t1),
+ * server send (t2) and client receive (t3). Assuming symmetric paths, the
+ * exchange measures
+ *
+ *     offset = ((t1 - t0) + (t2 - t3)) / 2,   delay = (t3 - t0) - (t2 - t1)
+ *
+ * Queueing only ever adds delay, and the offset error is at most delay / 2, so
+ * of the last WINDOW exchanges only the one with the lowest delay is trusted
+ * (the NTP clock filter). Each newly trusted sample corrects a linear model
+ * offset + drift * (t - ref) with a second-order loop: the offset moves by
+ * OFFSET_GAIN of the error, and the drift by DRIFT_GAIN of the error rate.
+ *
+ * All times are microseconds. Not thread-safe; guard with the owner's lock.
+ */
+class ClockSync
+{
+public:
+        static constexpr size_t WINDOW      = 8;       ///< Exchanges considered by the minimum-delay filter
+        static constexpr double OFFSET_GAIN = 0.25;    ///< Share of an offset error corrected per update
+        static constexpr double DRIFT_GAIN  = 0.05;    ///< Share of an error rate folded into the drift
+        static constexpr double MAX_DRIFT   = 500e-6;  ///< Clamp (500 ppm, far beyond real crystal drift)
+
+        /**
+         * @brief Add one completed exchange
+         * @param t0 Client clock when the request was sent
+         * @param t1 Server clock when the request was received
+         * @param t2 Server clock when the response was sent
+         * @param t3 Client clock when the response was received
+         */
+        void add_sample(int64_t t0, int64_t t1, int64_t t2, int64_t t3)
+        {
+                Sample s;
+                s.at     = t3;
+                s.delay  = std::max<int64_t>(0, (t3 - t0) - (t2 - t1));
+                s.offset = (static_cast<double>(t1 - t0) + static_cast<double>(t2 - t3)) / 2.0;
+
+                window_[count_ % WINDOW] = s;
+                count_++;
+
+                // Trust only the lowest-delay exchange in the window, and each one only once
+                const Sample* best = &window_[0];
+                for (size_t i = 1; i < std::min(count_, WINDOW); ++i)
+                {
+                        if (window_[i].delay < best->delay)
+                                best = &window_[i];
+                }
+                if (updates_ > 0 && best->at <= ref_us_)
+                        return;
+
+                update(*best);
+        }
+
+        /**
+         * @brief Check whether at least one exchange has been applied
+         */
+        bool synced() const { return updates_ > 0; }
+
+        /**
+         * @brief Estimate the server clock
+         * @param client_us Client clock reading
+         * @return Server clock at that instant (only meaningful once synced())
+         */
+        int64_t server_time_us(int64_t client_us) const
+        {
+                double elapsed = static_cast<double>(client_us - ref_us_);
+                return client_us + static_cast<int64_t>(offset_us_ + drift_ * elapsed);
+        }
+
+        /**
+         * @brief Get the current offset estimate (server minus client)
+         * @param client_us Client clock reading
+         */
+        double offset_us(int64_t client_us) const
+        {
+                return offset_us_ + drift_ * static_cast<double>(client_us - ref_us_);
+        }
+
+        double drift_ppm() const { return drift_ * 1e6; }                   ///< Server clock rate error (ppm)
+        int64_t delay_us() const { return delay_us_; }                      ///< Round trip of the last trusted exchange
+        uint64_t samples() const { return static_cast<uint64_t>(count_); }  ///< Exchanges received
+
+private:
+        struct Sample
+        {
+                int64_t at    = 0;  ///< Client receive time
+                int64_t delay = 0;
+                double offset = 0.0;
+        };
+
+        void update(const Sample& s)
+        {
+                if (updates_ == 0)
+                {
+                        offset_us_ = s.offset;
+                }
+                else
+                {
+                        double elapsed   = static_cast<double>(s.at - ref_us_);
+                        double predicted = offset_us_ + drift_ * elapsed;
+                        double error     = s.offset - predicted;
+                        offset_us_       = predicted + OFFSET_GAIN * error;
+                        if (elapsed > 0.0)
+                                drift_ = std::clamp(drift_ + DRIFT_GAIN * error / elapsed, -MAX_DRIFT, MAX_DRIFT);
+                }
+
+                ref_us_   = s.at;
+                delay_us_ = s.delay;
+                updates_++;
+        }
+
+        std::array<Sample, WINDOW> window_{};
+        size_t count_ = 0;  ///< Exchanges ever added
+
+        double offset_us_ = 0.0;  ///< Offset at ref_us_
+        double drift_     = 0.0;  ///< Offset change per client microsecond
+        int64_t ref_us_   = 0;    ///< Client time of the last applied sample
+        int64_t delay_us_ = 0;
+        uint64_t updates_ = 0;    ///< Samples applied to the model
+};
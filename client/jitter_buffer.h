@@ -0,0 +1,115 @@
+/**
+ * @file jitter_buffer.h
+ * @brief Adaptive playout delay for snapshot interpolation
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @class JitterBuffer
+ * @brief Sizes the interpolation delay from how late snapshots actually arrive
+ *
+ * To interpolate at server time T the client needs a snapshot stamped at or
+ * after T. Just before the next one arrives, the newest snapshot is about
+ * (age at arrival + broadcast interval) old, so the delay must cover that plus
+ * a margin for the variation in arrival age (network and scheduling jitter):
+ *
+ *     target = mean(age) + K * stddev(age) + mean(interval)
+ *
+ * Age and interval are exponentially weighted (weight GAIN per snapshot, as in
+ * the RFC 3550 jitter estimator), so the target follows the link within a few
+ * seconds. The delay in use moves toward the target by at most SLEW of the
+ * elapsed playback time: the render clock runs between 0.9x and 1.1x instead
+ * of jumping, so a change is never visible as a time warp.
+ *
+ * Times are milliseconds of server time. Not thread-safe; guard with the owner's lock.
+ */
+class JitterBuffer
+{
+public:
+        static constexpr double GAIN            = 1.0 / 16.0;  ///< EWMA weight of each snapshot
+        static constexpr double K               = 3.0;         ///< Standard deviations of margin against late snapshots
+        static constexpr double SLEW            = 0.1;         ///< Largest delay change per unit of playback time
+        static constexpr double MAX_DELAY_MS    = 500.0;       ///< Upper bound (the snapshot history spans 1s)
+        static constexpr uint64_t READY_SAMPLES = 3;           ///< Snapshots needed for a first estimate
+
+        /**
+         * @brief Construct with the delay to use until snapshots have been measured
+         * @param initial_delay_ms Starting delay and target
+         */
+        explicit JitterBuffer(double initial_delay_ms) : delay_ms_(initial_delay_ms), target_ms_(initial_delay_ms)
+        {
+        }
+
+        /**
+         * @brief Record one snapshot arrival
+         * @param server_ts_ms Server timestamp in the snapshot
+         * @param age_ms Server time (from clock sync) when the snapshot became usable, minus server_ts_ms
+         */
+        void add_snapshot(uint64_t server_ts_ms, double age_ms)
+        {
+                if (samples_ == 0)
+                {
+                        age_mean_ = age_ms;
+                }
+                else
+                {
+                        double diff = age_ms - age_mean_;
+                        age_mean_  += GAIN * diff;
+                        age_var_    = (1.0 - GAIN) * (age_var_ + GAIN * diff * diff);
+
+                        // Stamps are 32-bit on the wire: a signed difference stays correct across the wrap
+                        auto delta      = static_cast<int32_t>(static_cast<uint32_t>(server_ts_ms - last_ts_ms_));
+                        double interval = static_cast<double>(delta);
+                        if (samples_ == 1)
+                                interval_mean_ = interval;
+                        else
+                                interval_mean_ += GAIN * (interval - interval_mean_);
+                }
+                last_ts_ms_ = server_ts_ms;
+                samples_++;
+
+                // Wait for one interval and one spread estimate before trusting the target
+                if (ready())
+                {
+                        double target = age_mean_ + K * std::sqrt(age_var_) + interval_mean_;
+                        target_ms_    = std::clamp(target, 0.0, MAX_DELAY_MS);
+
+                        // The first estimate replaces the initial guess outright: nothing smooth is playing yet
+                        if (samples_ == READY_SAMPLES)
+                                delay_ms_ = target_ms_;
+                }
+        }
+
+        /**
+         * @brief Ease the delay in use toward the target
+         * @param dt_ms Playback time elapsed since the previous call
+         * @return Delay to render with
+         */
+        double advance(double dt_ms)
+        {
+                double step = SLEW * std::max(0.0, dt_ms);
+                delay_ms_   = std::clamp(target_ms_, delay_ms_ - step, delay_ms_ + step);
+                return delay_ms_;
+        }
+
+        bool ready() const { return samples_ >= READY_SAMPLES; }  ///< Whether the target reflects the link
+        double delay_ms() const { return delay_ms_; }             ///< Delay in use
+        double target_ms() const { return target_ms_; }           ///< Delay the link calls for
+        double jitter_ms() const { return std::sqrt(age_var_); }  ///< Standard deviation of arrival age
+        uint64_t samples() const { return samples_; }             ///< Snapshots recorded
+
+private:
+        double delay_ms_;
+        double target_ms_;
+        double age_mean_      = 0.0;  ///< Server time between stamping and arrival
+        double age_var_       = 0.0;
+        double interval_mean_ = 0.0;  ///< Server time between consecutive snapshots
+        uint64_t last_ts_ms_  = 0;
+        uint64_t samples_     = 0;
+};
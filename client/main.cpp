@@ -46,6 +46,9 @@ int main(int argc, char* argv[])
                             }
                     });
 
+                // Prediction, reconciliation and interpolation on their own thread, fed by the network thread
+                client.start_simulation();
+
                 // Rendering on main thread
                 Renderer renderer(800, 600);
                 if (!renderer.init())
@@ -56,9 +59,7 @@ int main(int argc, char* argv[])
                 }
 
                 SDL_Event event;
-                auto last_frame = std::chrono::steady_clock::now();
-
-                bool keys[4]    = {false};  // W, A, S, D
+                bool keys[4] = {false};  // W, A, S, D
 
                 while (renderer.is_running())
                 {
@@ -118,12 +119,7 @@ int main(int argc, char* argv[])
                                 }
                         }
 
-                        // Calculate delta time
-                        auto now   = std::chrono::steady_clock::now();
-                        float dt   = std::chrono::duration<float>(now - last_frame).count();
-                        last_frame = now;
-
-                        // Send input
+                        // Held direction
                         float dx = 0.0f, dy = 0.0f;
                         if (keys[0])
                                 dy -= 1.0f;  // W
@@ -134,24 +130,17 @@ int main(int argc, char* argv[])
                         if (keys[3])
                                 dx += 1.0f;  // D
 
-                        if (dx != 0.0f || dy != 0.0f)
-                        {
-                                // Apply local prediction immediately so movement
-                                // feels responsive while waiting for the server.
-                                client.apply_local_input(dx, dy, dt);
-                                client.send_input(dx, dy);
-                        }
-
-                        // Update interpolation
-                        client.update_interpolation(dt);
+                        // Sampled, predicted and sent at a fixed rate by the simulation thread; (0, 0) stops
+                        client.set_input(dx, dy);
 
-                        // Render
-                        renderer.render(client);
+                        // Render the latest published frame; no lock, no copy
+                        renderer.render(client.acquire_render_frame());
 
                         // Cap at 60 FPS
                         SDL_Delay(16);
                 }
 
+                client.stop_simulation();
                 io.stop();
                 network_thread.join();
         }
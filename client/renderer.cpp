@@ -95,13 +95,13 @@ void Renderer::draw_circle(int cx, int cy, int radius, SDL_Color color)
         }
 }
 
-void Renderer::render(const GameClient& client)
+void Renderer::render(const RenderFrame& frame)
 {
         // Clear screen
         SDL_SetRenderDrawColor(renderer_, 20, 20, 30, 255);
         SDL_RenderClear(renderer_);
 
-        if (!client.is_connected())
+        if (!frame.connected)
         {
                 // draw_text("Connecting...", 300, 250, {255, 255, 255, 255});
                 SDL_RenderPresent(renderer_);
@@ -109,27 +109,26 @@ void Renderer::render(const GameClient& client)
         }
 
         // Draw coins
-        for (const auto& [id, coin] : client.get_coins())
+        for (const protocol::Vec2& coin : frame.coins)
         {
-                draw_circle(static_cast<int>(coin.position.x), static_cast<int>(coin.position.y), 15, {255, 215, 0, 255}
+                draw_circle(static_cast<int>(coin.x), static_cast<int>(coin.y), 15, {255, 215, 0, 255}
                             // Gold
                 );
         }
 
         // Draw players
-        uint32_t my_id = client.get_my_id();
-        for (const auto& [id, player] : client.get_players())
+        for (const RenderFrame::Player& player : frame.players)
         {
-                SDL_Color color = (id == my_id) ? SDL_Color{0, 255, 0, 255}       // Green for local player
-                                                : SDL_Color{100, 150, 255, 255};  // Blue for remote players
+                SDL_Color color = (player.id == frame.my_id) ? SDL_Color{0, 255, 0, 255}       // Green for local player
+                                                             : SDL_Color{100, 150, 255, 255};  // Blue for remote players
 
-                draw_circle(static_cast<int>(player.render_pos.x), static_cast<int>(player.render_pos.y), 25, color);
+                draw_circle(static_cast<int>(player.position.x), static_cast<int>(player.position.y), 25, color);
 
                 // Draw score above player
-                std::string score_text = "P" + std::to_string(id) + ": " + std::to_string(player.score);
-                draw_text(score_text,
-                          static_cast<int>(player.render_pos.x) - 30,
-                          static_cast<int>(player.render_pos.y) - 50,
+                text_ = "P" + std::to_string(player.id) + ": " + std::to_string(player.score);
+                draw_text(text_,
+                          static_cast<int>(player.position.x) - 30,
+                          static_cast<int>(player.position.y) - 50,
                           {255, 255, 255, 255});
         }
 
@@ -138,15 +137,15 @@ void Renderer::render(const GameClient& client)
 
         // // Draw ping and general UI
         // std::ostringstream ss;
-        // ss << "Ping: " << static_cast<int>(client.get_ping_ms()) << " ms";
+        // ss << "Ping: " << static_cast<int>(frame.ping_ms) << " ms";
         // draw_text(ss.str(), width_ - 150, 10, {200, 200, 200, 255});
 
         // Draw total scores in top-left
         int y = 40;
-        for (const auto& [id, player] : client.get_players())
+        for (const RenderFrame::Player& player : frame.players)
         {
-                std::string s = "P" + std::to_string(id) + ": " + std::to_string(player.score);
-                draw_text(s, 10, y, {240, 240, 240, 255});
+                text_ = "P" + std::to_string(player.id) + ": " + std::to_string(player.score);
+                draw_text(text_, 10, y, {240, 240, 240, 255});
                 y += 20;
         }
 
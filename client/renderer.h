@@ -39,10 +39,10 @@ public:
         bool init();
 
         /**
-         * @brief Render current game state
-         * @param client Game client to read state from
+         * @brief Render one published frame
+         * @param frame Frame from GameClient::acquire_render_frame() (read without locks)
          */
-        void render(const GameClient& client);
+        void render(const RenderFrame& frame);
 
         /**
          * @brief Clean up SDL resources
@@ -65,6 +65,8 @@ private:
         void draw_circle(int cx, int cy, int radius, SDL_Color color);
         void draw_text(const std::string& text, int x, int y, SDL_Color color);
 
+        std::string text_;  ///< Label scratch, reused across frames
+
         SDL_Window* window_;
         SDL_Renderer* renderer_;
 #ifdef USE_SDL_TTF
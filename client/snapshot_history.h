@@ -0,0 +1,198 @@
+/**
+ * @file snapshot_history.h
+ * @brief Fixed-size ring buffer of received server snapshots for interpolation
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include "protocol.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class SnapshotHistory
+ * @brief Recent snapshots as flat, id-sorted player arrays, searchable by server time
+ *
+ * Storage is allocated once: CAPACITY frames of up to MAX_PLAYERS (id, position,
+ * velocity) entries, frame-major. Pushing a snapshot overwrites the oldest frame. Entries
+ * are sorted by player id when a frame is committed, so a caller walking its own
+ * id-ordered player list can locate every player in a frame with one merge-join
+ * pass instead of a lookup per player.
+ */
+class SnapshotHistory
+{
+public:
+        static constexpr size_t CAPACITY    = 64;   ///< Frames kept (>1s at the default 20Hz snapshot rate)
+        static constexpr size_t MAX_PLAYERS = 255;  ///< Protocol limit (player count is one byte)
+
+        /**
+         * @struct Entry
+         * @brief One player in a frame
+         */
+        struct Entry
+        {
+                uint32_t id;
+                protocol::Vec2 position;
+                protocol::Vec2 velocity;  ///< Units/s, as sent by the server
+        };
+
+        /**
+         * @class Cursor
+         * @brief Forward-only merge-join position in one frame
+         *
+         * Seeking ascending player IDs costs O(players in frame) in total for the
+         * whole walk, with no hashing.
+         */
+        class Cursor
+        {
+        public:
+                Cursor() = default;
+                Cursor(const Entry* entries, size_t count) : entries_(entries), count_(count) {}
+
+                /**
+                 * @brief Advance to a player
+                 * @param id Player ID, not lower than the previous seek
+                 * @return Entry, or nullptr if the frame does not contain the player
+                 */
+                const Entry* seek(uint32_t id)
+                {
+                        while (next_ < count_ && entries_[next_].id < id)
+                                ++next_;
+                        return next_ < count_ && entries_[next_].id == id ? &entries_[next_] : nullptr;
+                }
+
+        private:
+                const Entry* entries_ = nullptr;
+                size_t count_         = 0;
+                size_t next_          = 0;
+        };
+
+        SnapshotHistory() : entries_(CAPACITY * MAX_PLAYERS) {}
+
+        /**
+         * @brief Start a new newest frame, evicting the oldest if full
+         * @param server_ts_ms Server timestamp of the snapshot, unwrapped so stamps only ever increase
+         * @note Fill with add() and finish with commit()
+         */
+        void begin(uint64_t server_ts_ms)
+        {
+                if (size_ == CAPACITY)
+                {
+                        head_ = (head_ + 1) % CAPACITY;
+                        size_--;
+                }
+
+                Frame& frame       = frames_[slot(size_)];
+                frame.server_ts_ms = server_ts_ms;
+                frame.count        = 0;
+        }
+
+        /**
+         * @brief Append a player to the frame being built (extra players beyond MAX_PLAYERS are dropped)
+         * @param id Player ID
+         * @param position Server position
+         * @param velocity Server velocity
+         */
+        void add(uint32_t id, const protocol::Vec2& position, const protocol::Vec2& velocity)
+        {
+                size_t s     = slot(size_);
+                Frame& frame = frames_[s];
+                if (frame.count < MAX_PLAYERS)
+                        entries_[s * MAX_PLAYERS + frame.count++] = Entry{id, position, velocity};
+        }
+
+        /**
+         * @brief Sort the frame being built by player ID and make it the newest frame
+         */
+        void commit()
+        {
+                size_t s     = slot(size_);
+                Entry* first = &entries_[s * MAX_PLAYERS];
+                Entry* last  = first + frames_[s].count;
+                if (!std::is_sorted(first, last, by_id))
+                        std::sort(first, last, by_id);
+                size_++;
+        }
+
+        /**
+         * @brief Drop the oldest frames until the history spans at most keep_ms (always keeps one)
+         * @param keep_ms Maximum server-time span to retain
+         */
+        void trim(uint64_t keep_ms)
+        {
+                while (size_ > 1 && timestamp(size_ - 1) - timestamp(0) > keep_ms)
+                {
+                        head_ = (head_ + 1) % CAPACITY;
+                        size_--;
+                }
+        }
+
+        /**
+         * @brief Find the pair of consecutive frames around a server time (binary search)
+         * @param target_ts Server time to bracket
+         * @return Index i with timestamp(i) <= target_ts <= timestamp(i + 1), or size() if none
+         */
+        size_t bracket(uint64_t target_ts) const
+        {
+                if (size_ < 2 || target_ts < timestamp(0) || target_ts > timestamp(size_ - 1))
+                        return size_;
+
+                // First frame stamped after target_ts; the bracket starts one before it
+                size_t lo = 0, hi = size_;
+                while (lo < hi)
+                {
+                        size_t mid = lo + (hi - lo) / 2;
+                        if (timestamp(mid) <= target_ts)
+                                lo = mid + 1;
+                        else
+                                hi = mid;
+                }
+                return lo == size_ ? size_ - 2 : lo - 1;
+        }
+
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        /**
+         * @brief Get a frame's server timestamp
+         * @param i Frame index, 0 = oldest
+         */
+        uint64_t timestamp(size_t i) const { return frames_[slot(i)].server_ts_ms; }
+
+        /**
+         * @brief Get a frame's players, sorted by ID
+         * @param i Frame index, 0 = oldest
+         * @return Pointer to count(i) entries
+         */
+        const Entry* entries(size_t i) const { return &entries_[slot(i) * MAX_PLAYERS]; }
+
+        /**
+         * @brief Get a frame's player count
+         * @param i Frame index, 0 = oldest
+         */
+        size_t count(size_t i) const { return frames_[slot(i)].count; }
+
+        /**
+         * @brief Start a merge-join walk over a frame
+         * @param i Frame index, 0 = oldest; out of range gives an empty cursor
+         */
+        Cursor cursor(size_t i) const { return i < size_ ? Cursor(entries(i), count(i)) : Cursor(); }
+
+private:
+        struct Frame
+        {
+                uint64_t server_ts_ms = 0;
+                uint32_t count        = 0;
+        };
+
+        static bool by_id(const Entry& a, const Entry& b) { return a.id < b.id; }
+        size_t slot(size_t i) const { return (head_ + i) % CAPACITY; }
+
+        Frame frames_[CAPACITY];
+        std::vector<Entry> entries_;  ///< CAPACITY x MAX_PLAYERS, frame-major
+        size_t head_ = 0;             ///< Slot of the oldest frame
+        size_t size_ = 0;             ///< Committed frames
+};
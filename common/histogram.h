@@ -0,0 +1,170 @@
+/**
+ * @file histogram.h
+ * @brief Fixed-size log-linear (HDR-style) histogram for latency recording
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+/**
+ * @class Histogram
+ * @brief Records non-negative integer samples with bounded relative error
+ *
+ * Values below SUB_BUCKETS are counted exactly; above that each power-of-two
+ * range is split into SUB_BUCKETS / 2 linear buckets, so any recorded value is
+ * reported within ~3% (1 / 32). Storage is one fixed array (about 9.5 KB),
+ * record() is a few integer operations and one increment with no allocation,
+ * and histograms of the same shape can be merged.
+ *
+ * Not thread-safe: record and read from the owning thread (or under its lock).
+ * Samples above MAX_VALUE are clamped into the top bucket.
+ */
+class Histogram
+{
+public:
+        static constexpr int SUB_BUCKET_BITS  = 6;
+        static constexpr uint64_t SUB_BUCKETS = 1ull << SUB_BUCKET_BITS;  ///< Values below this are exact
+        static constexpr int MAX_BIT          = 40;                       ///< Highest trackable bit (~25 days in us)
+        static constexpr uint64_t MAX_VALUE   = (1ull << (MAX_BIT + 1)) - 1;
+        static constexpr size_t BUCKET_COUNT  = SUB_BUCKETS + (MAX_BIT - SUB_BUCKET_BITS + 1) * (SUB_BUCKETS / 2);
+
+        Histogram() { reset(); }
+
+        /**
+         * @brief Record one sample
+         * @param value Sample value (e.g. microseconds)
+         */
+        void record(uint64_t value)
+        {
+                value = std::min(value, MAX_VALUE);
+                counts_[bucket_index(value)]++;
+                total_++;
+                sum_ += value;
+                min_  = std::min(min_, value);
+                max_  = std::max(max_, value);
+        }
+
+        /**
+         * @brief Add all samples of another histogram
+         * @param other Histogram to merge
+         */
+        void merge(const Histogram& other)
+        {
+                for (size_t i = 0; i < BUCKET_COUNT; ++i)
+                        counts_[i] += other.counts_[i];
+                total_ += other.total_;
+                sum_   += other.sum_;
+                min_    = std::min(min_, other.min_);
+                max_    = std::max(max_, other.max_);
+        }
+
+        /**
+         * @brief Remove all samples
+         */
+        void reset()
+        {
+                counts_.fill(0);
+                total_ = 0;
+                sum_   = 0;
+                min_   = UINT64_MAX;
+                max_   = 0;
+        }
+
+        uint64_t count() const { return total_; }
+        uint64_t min() const { return total_ ? min_ : 0; }
+        uint64_t max() const { return max_; }
+        double mean() const { return total_ ? static_cast<double>(sum_) / static_cast<double>(total_) : 0.0; }
+
+        /**
+         * @brief Get the value at a percentile
+         * @param percentile Percentile in [0, 100]
+         * @return Upper bound of the bucket holding that rank (never above max())
+         */
+        uint64_t value_at_percentile(double percentile) const
+        {
+                if (total_ == 0)
+                        return 0;
+
+                double p      = std::min(100.0, std::max(0.0, percentile));
+                uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(total_) + 0.5);
+                rank          = std::max<uint64_t>(1, std::min(rank, total_));
+
+                uint64_t seen = 0;
+                for (size_t i = 0; i < BUCKET_COUNT; ++i)
+                {
+                        seen += counts_[i];
+                        if (seen >= rank)
+                                return std::min(bucket_upper(i), max_);
+                }
+                return max_;
+        }
+
+        /**
+         * @brief Format count, mean and the usual tail percentiles on one line
+         * @param unit Unit label appended to values
+         * @return Summary text
+         */
+        std::string summary(const char* unit = "us") const
+        {
+                char buf[256];
+                std::snprintf(buf,
+                              sizeof(buf),
+                              "n=%llu mean=%.1f p50=%llu p90=%llu p99=%llu p99.9=%llu max=%llu %s",
+                              static_cast<unsigned long long>(total_),
+                              mean(),
+                              static_cast<unsigned long long>(value_at_percentile(50.0)),
+                              static_cast<unsigned long long>(value_at_percentile(90.0)),
+                              static_cast<unsigned long long>(value_at_percentile(99.0)),
+                              static_cast<unsigned long long>(value_at_percentile(99.9)),
+                              static_cast<unsigned long long>(max_),
+                              unit);
+                return buf;
+        }
+
+private:
+        static int highest_bit(uint64_t v)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+                return 63 - __builtin_clzll(v);
+#else
+                int bit = 0;
+                while (v >>= 1)
+                        ++bit;
+                return bit;
+#endif
+        }
+
+        static size_t bucket_index(uint64_t v)
+        {
+                if (v < SUB_BUCKETS)
+                        return static_cast<size_t>(v);
+
+                // shift >= 1; mantissa lands in [SUB_BUCKETS / 2, SUB_BUCKETS)
+                int shift         = highest_bit(v) - (SUB_BUCKET_BITS - 1);
+                uint64_t mantissa = v >> shift;
+                return static_cast<size_t>(SUB_BUCKETS + (shift - 1) * (SUB_BUCKETS / 2) + (mantissa - SUB_BUCKETS / 2));
+        }
+
+        static uint64_t bucket_upper(size_t index)
+        {
+                if (index < SUB_BUCKETS)
+                        return index;
+
+                size_t k          = index - SUB_BUCKETS;
+                int shift         = static_cast<int>(k / (SUB_BUCKETS / 2)) + 1;
+                uint64_t mantissa = k % (SUB_BUCKETS / 2) + SUB_BUCKETS / 2;
+                return ((mantissa + 1) << shift) - 1;
+        }
+
+        std::array<uint64_t, BUCKET_COUNT> counts_;
+        uint64_t total_;
+        uint64_t sum_;
+        uint64_t min_;
+        uint64_t max_;
+};
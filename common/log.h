@@ -0,0 +1,587 @@
+/**
+ * @file log.h
+ * @brief Asynchronous structured logger: lock-free record push, formatting on a background thread
+ * @author NetworkGame Project
+ * @date 2024
+ *
+ * Usage:
+ * @code
+ * LOG_INFO("Player {} collected coin. Score: {}", player_id, score);
+ * LOG_WARN("Connection {} error: {}", id, ec.message());
+ * @endcode
+ *
+ * A call site copies its arguments (numbers by value, strings into a small
+ * inline buffer) into a fixed-size Record and pushes it onto an MpscQueue.
+ * No formatting, allocation, locking or I/O happens on the caller's thread; the
+ * writer thread formats "{}" placeholders and hands the result to the sinks.
+ * If the queue is full the record is dropped and counted, never waited for.
+ *
+ * Levels below LOG_MIN_LEVEL (0 = debug .. 3 = error, default 0) are removed at
+ * compile time; the rest are filtered at runtime by Logger::set_level().
+ */
+
+#pragma once
+#include "mpsc_queue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
+
+namespace logging
+{
+        /**
+         * @brief Record severity (ERR, not ERROR: <windows.h> defines ERROR)
+         */
+        enum class Level : uint8_t
+        {
+                DEBUG = 0,
+                INFO  = 1,
+                WARN  = 2,
+                ERR   = 3
+        };
+
+        inline const char* level_name(Level level)
+        {
+                static const char* const names[] = {"DEBUG", "INFO ", "WARN ", "ERROR"};
+                return static_cast<size_t>(level) < 4 ? names[static_cast<size_t>(level)] : "?    ";
+        }
+
+        /**
+         * @brief Type tag of one captured argument
+         */
+        enum class ArgType : uint8_t
+        {
+                I64 = 1,
+                U64 = 2,
+                F64 = 3,
+                STR = 4  ///< Bytes in Record::text, located by Arg::str
+        };
+
+        /**
+         * @struct Record
+         * @brief One log call, captured without formatting
+         */
+        struct Record
+        {
+                static constexpr size_t MAX_ARGS   = 6;    ///< Arguments per call (checked at compile time)
+                static constexpr size_t TEXT_BYTES = 112;  ///< Shared by all string arguments; longer text is cut
+
+                union Arg
+                {
+                        int64_t i;
+                        uint64_t u;
+                        double f;
+                        struct
+                        {
+                                uint16_t offset;
+                                uint16_t length;
+                        } str;
+                };
+
+                uint64_t time_us;  ///< Microseconds since the logger started
+                const char* fmt;   ///< Format string with "{}" placeholders (must be a string literal)
+                Level level;
+                uint8_t arg_count;
+                uint16_t text_used;
+                ArgType types[MAX_ARGS];
+                Arg args[MAX_ARGS];
+                char text[TEXT_BYTES];
+
+                void add(int64_t v)
+                {
+                        types[arg_count]    = ArgType::I64;
+                        args[arg_count++].i = v;
+                }
+
+                void add(uint64_t v)
+                {
+                        types[arg_count]    = ArgType::U64;
+                        args[arg_count++].u = v;
+                }
+
+                void add(double v)
+                {
+                        types[arg_count]    = ArgType::F64;
+                        args[arg_count++].f = v;
+                }
+
+                void add(const char* s, size_t length)
+                {
+                        size_t n = std::min(length, TEXT_BYTES - text_used);
+                        std::memcpy(text + text_used, s, n);
+                        types[arg_count]             = ArgType::STR;
+                        args[arg_count].str.offset   = text_used;
+                        args[arg_count++].str.length = static_cast<uint16_t>(n);
+                        text_used                    = static_cast<uint16_t>(text_used + n);
+                }
+
+                template <typename T>
+                void capture(const T& v)
+                {
+                        if constexpr (std::is_same_v<T, bool>)
+                                add(static_cast<uint64_t>(v));
+                        else if constexpr (std::is_enum_v<T>)
+                                add(static_cast<int64_t>(v));
+                        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+                                add(static_cast<int64_t>(v));
+                        else if constexpr (std::is_integral_v<T>)
+                                add(static_cast<uint64_t>(v));
+                        else if constexpr (std::is_floating_point_v<T>)
+                                add(static_cast<double>(v));
+                        else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+                        {
+                                std::string_view s(v);
+                                add(s.data(), s.size());
+                        }
+                        else
+                                static_assert(std::is_arithmetic_v<T>, "Unsupported log argument type");
+                }
+        };
+
+        /**
+         * @brief Expand a record's "{}" placeholders into text
+         * @param r Captured record
+         * @param out Appended with the message (no level, time or newline)
+         */
+        inline void format_message(const Record& r, std::string& out)
+        {
+                size_t next = 0;
+                char number[32];
+                for (const char* p = r.fmt; *p; ++p)
+                {
+                        if (p[0] != '{' || p[1] != '}' || next >= r.arg_count)
+                        {
+                                out += *p;
+                                continue;
+                        }
+
+                        const Record::Arg& a = r.args[next];
+                        switch (r.types[next++])
+                        {
+                        case ArgType::I64:
+                                std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(a.i));
+                                out += number;
+                                break;
+                        case ArgType::U64:
+                                std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(a.u));
+                                out += number;
+                                break;
+                        case ArgType::F64:
+                                std::snprintf(number, sizeof(number), "%g", a.f);
+                                out += number;
+                                break;
+                        case ArgType::STR:
+                                out.append(r.text + a.str.offset, a.str.length);
+                                break;
+                        }
+                        ++p;
+                }
+        }
+
+        /**
+         * @brief Format a full line: "[seconds] LEVEL message\n"
+         */
+        inline void format_line(const Record& r, std::string& out)
+        {
+                char prefix[40];
+                std::snprintf(prefix,
+                              sizeof(prefix),
+                              "[%6llu.%06llu] %s ",
+                              static_cast<unsigned long long>(r.time_us / 1000000),
+                              static_cast<unsigned long long>(r.time_us % 1000000),
+                              level_name(r.level));
+                out += prefix;
+                format_message(r, out);
+                out += '\n';
+        }
+
+        /**
+         * @class Sink
+         * @brief Destination for records; only ever called from the writer thread
+         */
+        class Sink
+        {
+        public:
+                virtual ~Sink()                     = default;
+                virtual void write(const Record& r) = 0;
+                virtual void flush()                = 0;
+        };
+
+        /**
+         * @class TextSink
+         * @brief Human-readable lines to a FILE* (stdout by default) or a file
+         */
+        class TextSink : public Sink
+        {
+        public:
+                explicit TextSink(std::FILE* out = stdout) : file_(out), owned_(false) {}
+
+                explicit TextSink(const std::string& path) : file_(std::fopen(path.c_str(), "ab")), owned_(true)
+                {
+                        if (!file_)
+                                throw std::runtime_error("Cannot open log file " + path);
+                }
+
+                ~TextSink() override
+                {
+                        if (owned_)
+                                std::fclose(file_);
+                }
+
+                void write(const Record& r) override
+                {
+                        line_.clear();
+                        format_line(r, line_);
+                        std::fwrite(line_.data(), 1, line_.size(), file_);
+                }
+
+                void flush() override { std::fflush(file_); }
+
+        private:
+                std::FILE* file_;
+                bool owned_;
+                std::string line_;  ///< Reused so steady-state writes do not allocate
+        };
+
+        constexpr char BINARY_MAGIC[4]    = {'N', 'G', 'L', 'G'};
+        constexpr uint32_t BINARY_VERSION = 1;
+
+        /**
+         * @class BinarySink
+         * @brief Compact unformatted records; read back with BinaryReader (tools/logcat)
+         *
+         * Layout after the "NGLG" magic and u32 version, per record: u8 level,
+         * u64 time_us, u16 format length + bytes, u8 arg count, then per argument
+         * u8 type and either 8 value bytes or u16 length + string bytes.
+         * Integers are in host byte order.
+         */
+        class BinarySink : public Sink
+        {
+        public:
+                explicit BinarySink(const std::string& path) : file_(std::fopen(path.c_str(), "wb"))
+                {
+                        if (!file_)
+                                throw std::runtime_error("Cannot open log file " + path);
+                        std::fwrite(BINARY_MAGIC, 1, sizeof(BINARY_MAGIC), file_);
+                        std::fwrite(&BINARY_VERSION, sizeof(BINARY_VERSION), 1, file_);
+                }
+
+                ~BinarySink() override { std::fclose(file_); }
+
+                void write(const Record& r) override
+                {
+                        uint16_t fmt_length = static_cast<uint16_t>(std::strlen(r.fmt));
+                        std::fwrite(&r.level, 1, 1, file_);
+                        std::fwrite(&r.time_us, sizeof(r.time_us), 1, file_);
+                        std::fwrite(&fmt_length, sizeof(fmt_length), 1, file_);
+                        std::fwrite(r.fmt, 1, fmt_length, file_);
+                        std::fwrite(&r.arg_count, 1, 1, file_);
+                        for (size_t i = 0; i < r.arg_count; ++i)
+                        {
+                                std::fwrite(&r.types[i], 1, 1, file_);
+                                if (r.types[i] == ArgType::STR)
+                                {
+                                        std::fwrite(&r.args[i].str.length, sizeof(uint16_t), 1, file_);
+                                        std::fwrite(r.text + r.args[i].str.offset, 1, r.args[i].str.length, file_);
+                                }
+                                else
+                                {
+                                        std::fwrite(&r.args[i].u, sizeof(uint64_t), 1, file_);
+                                }
+                        }
+                }
+
+                void flush() override { std::fflush(file_); }
+
+        private:
+                std::FILE* file_;
+        };
+
+        /**
+         * @class BinaryReader
+         * @brief Decodes a BinarySink file back into Records
+         */
+        class BinaryReader
+        {
+        public:
+                explicit BinaryReader(const std::string& path) : file_(std::fopen(path.c_str(), "rb"))
+                {
+                        if (!file_)
+                                throw std::runtime_error("Cannot open log file " + path);
+
+                        char magic[sizeof(BINARY_MAGIC)];
+                        uint32_t version = 0;
+                        if (!get(magic, sizeof(magic)) || std::memcmp(magic, BINARY_MAGIC, sizeof(magic)) != 0 ||
+                            !get(&version, sizeof(version)) || version != BINARY_VERSION)
+                        {
+                                std::fclose(file_);
+                                throw std::runtime_error("Not a binary log (or unsupported version): " + path);
+                        }
+                }
+
+                ~BinaryReader() { std::fclose(file_); }
+
+                BinaryReader(const BinaryReader&)            = delete;
+                BinaryReader& operator=(const BinaryReader&) = delete;
+
+                /**
+                 * @brief Read the next record
+                 * @param out Decoded record; its fmt stays valid until the next call
+                 * @return false at end of file or on a truncated record
+                 */
+                bool next(Record& out)
+                {
+                        uint16_t fmt_length = 0;
+                        out                 = Record{};
+                        if (!get(&out.level, 1) || !get(&out.time_us, sizeof(out.time_us)) ||
+                            !get(&fmt_length, sizeof(fmt_length)))
+                                return false;
+
+                        fmt_.resize(fmt_length);
+                        uint8_t count = 0;
+                        if (!get(&fmt_[0], fmt_length) || !get(&count, 1) || count > Record::MAX_ARGS)
+                                return false;
+                        out.fmt = fmt_.c_str();
+
+                        for (size_t i = 0; i < count; ++i)
+                        {
+                                ArgType type;
+                                if (!get(&type, 1))
+                                        return false;
+
+                                if (type == ArgType::STR)
+                                {
+                                        uint16_t length = 0;
+                                        char text[Record::TEXT_BYTES];
+                                        if (!get(&length, sizeof(length)) || length > sizeof(text) ||
+                                            !get(text, length))
+                                                return false;
+                                        out.add(text, length);
+                                }
+                                else
+                                {
+                                        Record::Arg value;
+                                        if (!get(&value.u, sizeof(value.u)))
+                                                return false;
+                                        out.types[out.arg_count]  = type;
+                                        out.args[out.arg_count++] = value;
+                                }
+                        }
+                        return true;
+                }
+
+        private:
+                bool get(void* out, size_t size) { return size == 0 || std::fread(out, 1, size, file_) == size; }
+
+                std::FILE* file_;
+                std::string fmt_;
+        };
+
+        /**
+         * @class Logger
+         * @brief Owns the record queue, the sinks and the writer thread
+         */
+        class Logger
+        {
+        public:
+                static constexpr size_t QUEUE_CAPACITY = 8192;  ///< Records buffered before calls start dropping
+                static constexpr std::chrono::milliseconds IDLE_SLEEP{2};  ///< Writer poll interval when idle
+
+                Logger()
+                    : queue_(QUEUE_CAPACITY),
+                      level_(static_cast<uint8_t>(Level::INFO)),
+                      running_(true),
+                      pushed_(0),
+                      dropped_(0),
+                      flushed_(0),
+                      start_(std::chrono::steady_clock::now())
+                {
+                        sinks_.push_back(std::make_unique<TextSink>());
+                        writer_ = std::thread([this]() { writer_loop(); });
+                }
+
+                ~Logger()
+                {
+                        running_.store(false, std::memory_order_release);
+                        writer_.join();
+                }
+
+                Logger(const Logger&)            = delete;
+                Logger& operator=(const Logger&) = delete;
+
+                /**
+                 * @brief Replace all sinks with one
+                 * @param sink New destination
+                 */
+                void set_sink(std::unique_ptr<Sink> sink)
+                {
+                        std::lock_guard<std::mutex> lock(sinks_mutex_);
+                        sinks_.clear();
+                        sinks_.push_back(std::move(sink));
+                }
+
+                /**
+                 * @brief Add a destination alongside the existing ones
+                 * @param sink Extra destination
+                 */
+                void add_sink(std::unique_ptr<Sink> sink)
+                {
+                        std::lock_guard<std::mutex> lock(sinks_mutex_);
+                        sinks_.push_back(std::move(sink));
+                }
+
+                void set_level(Level level) { level_.store(static_cast<uint8_t>(level), std::memory_order_relaxed); }
+
+                bool enabled(Level level) const
+                {
+                        return static_cast<uint8_t>(level) >= level_.load(std::memory_order_relaxed);
+                }
+
+                /**
+                 * @brief Capture and enqueue one record (safe from any thread, never blocks)
+                 * @param level Severity
+                 * @param fmt String literal with "{}" placeholders
+                 * @param args Numbers, enums, or string-like values (copied, truncated to Record::TEXT_BYTES)
+                 */
+                template <typename... Args>
+                void write(Level level, const char* fmt, const Args&... args)
+                {
+                        static_assert(sizeof...(Args) <= Record::MAX_ARGS, "Too many log arguments");
+                        if (!enabled(level))
+                                return;
+
+                        Record r;
+                        r.time_us   = now_us();
+                        r.fmt       = fmt;
+                        r.level     = level;
+                        r.arg_count = 0;
+                        r.text_used = 0;
+                        (r.capture(args), ...);
+
+                        if (queue_.try_push(r))
+                                pushed_.fetch_add(1, std::memory_order_relaxed);
+                        else
+                                dropped_.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                /**
+                 * @brief Block until everything pushed so far has reached the sinks and been flushed
+                 * @note Not for hot paths; meant for shutdown and tests
+                 */
+                void flush()
+                {
+                        uint64_t target = pushed_.load(std::memory_order_relaxed);
+                        while (flushed_.load(std::memory_order_acquire) < target)
+                                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+
+                /**
+                 * @brief Get the number of records dropped because the queue was full
+                 * @return Dropped record count
+                 */
+                uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+        private:
+                uint64_t now_us() const
+                {
+                        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - start_);
+                        return static_cast<uint64_t>(elapsed.count());
+                }
+
+                void writer_loop()
+                {
+                        Record r;
+                        uint64_t written        = 0;
+                        uint64_t reported_drops = 0;
+                        bool dirty              = false;
+                        for (;;)
+                        {
+                                bool stopping = !running_.load(std::memory_order_acquire);
+                                {
+                                        std::lock_guard<std::mutex> lock(sinks_mutex_);
+                                        while (queue_.try_pop(r))
+                                        {
+                                                for (auto& sink : sinks_)
+                                                        sink->write(r);
+                                                written++;
+                                                dirty = true;
+                                        }
+
+                                        uint64_t drops = dropped_.load(std::memory_order_relaxed);
+                                        if (drops != reported_drops)
+                                        {
+                                                Record note{};
+                                                note.time_us = now_us();
+                                                note.fmt     = "Log queue full, dropped {} record(s)";
+                                                note.level   = Level::WARN;
+                                                note.add(drops - reported_drops);
+                                                for (auto& sink : sinks_)
+                                                        sink->write(note);
+                                                reported_drops = drops;
+                                                dirty          = true;
+                                        }
+
+                                        if (dirty)
+                                        {
+                                                for (auto& sink : sinks_)
+                                                        sink->flush();
+                                                flushed_.store(written, std::memory_order_release);
+                                                dirty = false;
+                                        }
+                                }
+
+                                if (stopping)
+                                        break;
+                                std::this_thread::sleep_for(IDLE_SLEEP);
+                        }
+                }
+
+                MpscQueue<Record> queue_;
+                std::atomic<uint8_t> level_;     ///< Runtime minimum level
+                std::atomic<bool> running_;
+                std::atomic<uint64_t> pushed_;   ///< Records successfully queued
+                std::atomic<uint64_t> dropped_;  ///< Records lost to a full queue
+                std::atomic<uint64_t> flushed_;  ///< Records written and flushed by the writer
+                std::chrono::steady_clock::time_point start_;
+
+                std::mutex sinks_mutex_;  ///< Held by the writer while draining; taken by set_sink/add_sink
+                std::vector<std::unique_ptr<Sink>> sinks_;
+                std::thread writer_;
+        };
+
+        /**
+         * @brief Process-wide logger, created with a stdout text sink on first use
+         */
+        inline Logger& logger()
+        {
+                static Logger instance;
+                return instance;
+        }
+}  // namespace logging
+
+#define LOG_AT(level, min, ...)                                                                                      \
+        do                                                                                                           \
+        {                                                                                                            \
+                if constexpr ((min) >= LOG_MIN_LEVEL)                                                                \
+                        ::logging::logger().write(level, __VA_ARGS__);                                               \
+        } while (0)
+
+#define LOG_DEBUG(...) LOG_AT(::logging::Level::DEBUG, 0, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(::logging::Level::INFO, 1, __VA_ARGS__)
+#define LOG_WARN(...) LOG_AT(::logging::Level::WARN, 2, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(::logging::Level::ERR, 3, __VA_ARGS__)
@@ -0,0 +1,111 @@
+/**
+ * @file movement.h
+ * @brief Player movement rules shared by the server simulation and client prediction
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @namespace movement
+ * @brief World constants, the per-tick movement step and the coin pickup test
+ *
+ * The server applies exactly one input per player per tick; the client predicts
+ * by applying the same step once per input it sends and replaying unacknowledged
+ * inputs the same way. Both sides run this code, and every target that includes
+ * it is built with floating-point contraction disabled (-ffp-contract=off, see
+ * the common library in CMake), so a prediction matches the server's result
+ * bit for bit unless inputs are lost or reordered.
+ */
+namespace movement
+{
+        constexpr uint32_t TICK_RATE = 60;                 ///< Simulation ticks per second
+        constexpr float TICK_DT      = 1.0f / TICK_RATE;  ///< Fixed simulation timestep (seconds)
+
+        constexpr float MAP_WIDTH     = 800.0f;  ///< Game world width
+        constexpr float MAP_HEIGHT    = 600.0f;  ///< Game world height
+        constexpr float PLAYER_SPEED  = 200.0f;  ///< Player movement speed (pixels/second)
+        constexpr float PLAYER_RADIUS = 25.0f;   ///< Player collision radius
+        constexpr float COIN_RADIUS   = 20.0f;   ///< Coin collision radius
+        constexpr float DEADZONE      = 0.01f;   ///< Inputs this short or shorter do not move
+
+        constexpr float PICKUP_DIST = PLAYER_RADIUS + COIN_RADIUS;  ///< Centre distance for a coin pickup
+
+        /**
+         * @struct Params
+         * @brief Constants for one integration step
+         */
+        struct Params
+        {
+                float speed;     ///< Units per second
+                float dt;        ///< Timestep in seconds
+                float deadzone;  ///< Inputs with length <= deadzone do not move
+                float min_x;     ///< Clamp bounds
+                float max_x;
+                float min_y;
+                float max_y;
+        };
+
+        /**
+         * @brief The game's movement rules: one tick at player speed, kept inside the map
+         */
+        constexpr Params PLAYER{PLAYER_SPEED,
+                                TICK_DT,
+                                DEADZONE,
+                                PLAYER_RADIUS,
+                                MAP_WIDTH - PLAYER_RADIUS,
+                                PLAYER_RADIUS,
+                                MAP_HEIGHT - PLAYER_RADIUS};
+
+        /**
+         * @brief Move a position by one step
+         *
+         * If |(dx, dy)| > deadzone, moves (x, y) by the normalized direction scaled
+         * by speed * dt and clamps to the bounds. The vectorized server kernels
+         * (sim::integrate) perform the same operations in the same order.
+         *
+         * @param x Position X (updated in place)
+         * @param y Position Y (updated in place)
+         * @param dx Input direction X
+         * @param dy Input direction Y
+         * @param p Movement constants
+         * @return true if the position was moved
+         */
+        inline bool step(float& x, float& y, float dx, float dy, const Params& p = PLAYER)
+        {
+                float len = std::sqrt(dx * dx + dy * dy);
+                if (!(len > p.deadzone))
+                        return false;
+
+                float nx = dx / len;
+                float ny = dy / len;
+                float tx = x + nx * p.speed * p.dt;
+                float ty = y + ny * p.speed * p.dt;
+                x        = std::max(p.min_x, std::min(p.max_x, tx));
+                y        = std::max(p.min_y, std::min(p.max_y, ty));
+                return true;
+        }
+
+        /**
+         * @brief The pickup test: a player collects a coin whose centre is closer than PICKUP_DIST
+         *
+         * The server applies it after each movement step (sim::overlaps is the vectorized form);
+         * the client applies it to its predicted position to hide coins before the server confirms.
+         *
+         * @param px Player X
+         * @param py Player Y
+         * @param cx Coin X
+         * @param cy Coin Y
+         * @return true if the player touches the coin
+         */
+        inline bool touches_coin(float px, float py, float cx, float cy)
+        {
+                float dx = px - cx;
+                float dy = py - cy;
+                return dx * dx + dy * dy < PICKUP_DIST * PICKUP_DIST;
+        }
+}  // namespace movement
@@ -0,0 +1,132 @@
+/**
+ * @file mpsc_queue.h
+ * @brief Bounded lock-free multi-producer single-consumer queue
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/**
+ * @class MpscQueue
+ * @brief Fixed-capacity lock-free queue with many producers and one consumer
+ *
+ * Based on Dmitry Vyukov's bounded queue: every cell carries a sequence number
+ * that tells producers whether the slot is free and the consumer whether it is
+ * filled. Producers claim a slot with a single CAS on the enqueue position; the
+ * consumer owns the dequeue position and never needs an atomic RMW.
+ *
+ * try_push() never blocks and never allocates. When the queue is full it
+ * returns false and the caller decides what to drop.
+ *
+ * @tparam T Element type (must be default constructible and movable)
+ */
+template <typename T>
+class MpscQueue
+{
+public:
+        /**
+         * @brief Construct queue
+         * @param capacity Minimum number of elements (rounded up to a power of two)
+         */
+        explicit MpscQueue(size_t capacity)
+        {
+                size_t cap = 2;
+                while (cap < capacity)
+                        cap <<= 1;
+
+                mask_  = cap - 1;
+                cells_ = std::make_unique<Cell[]>(cap);
+                for (size_t i = 0; i < cap; ++i)
+                        cells_[i].sequence.store(i, std::memory_order_relaxed);
+
+                enqueue_pos_.store(0, std::memory_order_relaxed);
+                dequeue_pos_ = 0;
+        }
+
+        MpscQueue(const MpscQueue&)            = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        /**
+         * @brief Push an element (safe from any thread)
+         * @param value Element to copy into the queue
+         * @return true if queued, false if the queue is full
+         */
+        bool try_push(const T& value)
+        {
+                Cell* cell;
+                size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                        cell          = &cells_[pos & mask_];
+                        size_t seq    = cell->sequence.load(std::memory_order_acquire);
+                        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                        if (diff == 0)
+                        {
+                                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                                        break;
+                        }
+                        else if (diff < 0)
+                        {
+                                return false;  // full
+                        }
+                        else
+                        {
+                                pos = enqueue_pos_.load(std::memory_order_relaxed);
+                        }
+                }
+
+                cell->value = value;
+                cell->sequence.store(pos + 1, std::memory_order_release);
+                return true;
+        }
+
+        /**
+         * @brief Pop an element (consumer thread only)
+         * @param out Output element
+         * @return true if an element was popped, false if the queue is empty
+         */
+        bool try_pop(T& out)
+        {
+                Cell* cell    = &cells_[dequeue_pos_ & mask_];
+                size_t seq    = cell->sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(dequeue_pos_ + 1);
+                if (diff < 0)
+                        return false;  // empty
+
+                out = std::move(cell->value);
+                cell->sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+                ++dequeue_pos_;
+                return true;
+        }
+
+        /**
+         * @brief Get queue capacity
+         * @return Maximum number of elements the queue can hold
+         */
+        size_t capacity() const { return mask_ + 1; }
+
+        /**
+         * @brief Get the number of queued elements (consumer thread only)
+         * @return Element count; may already be stale if producers are active
+         */
+        size_t size_approx() const { return enqueue_pos_.load(std::memory_order_relaxed) - dequeue_pos_; }
+
+private:
+        struct Cell
+        {
+                std::atomic<size_t> sequence;
+                T value;
+        };
+
+        std::unique_ptr<Cell[]> cells_;
+        size_t mask_;
+
+        alignas(64) std::atomic<size_t> enqueue_pos_;  ///< Shared by all producers
+        alignas(64) size_t dequeue_pos_;               ///< Owned by the consumer
+};
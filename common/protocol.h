@@ -6,6 +6,8 @@
  */
 
 #pragma once
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <vector>
@@ -23,11 +25,14 @@ namespace protocol
          */
         enum class MessageType : uint8_t
         {
-                CLIENT_CONNECT    = 1,
-                CLIENT_INPUT      = 2,
-                SERVER_GAME_STATE = 3,
-                SERVER_START_GAME = 4,
-                CLIENT_DISCONNECT = 5  ///< Client disconnection notification
+                CLIENT_CONNECT       = 1,
+                CLIENT_INPUT         = 2,
+                SERVER_GAME_STATE    = 3,
+                SERVER_START_GAME    = 4,
+                CLIENT_DISCONNECT    = 5,  ///< Client disconnection notification
+                CLIENT_INPUT_BATCH   = 6,  ///< Fixed-rate input commands, several per message
+                CLIENT_TIME_REQUEST  = 7,  ///< Clock sync probe (TimeSyncMessage, client field only)
+                SERVER_TIME_RESPONSE = 8   ///< Clock sync reply (TimeSyncMessage, all fields)
         };
 
         /**
@@ -54,11 +59,30 @@ namespace protocol
         {
                 uint32_t id;
                 Vec2 position;
+                Vec2 velocity;  ///< Units/s over the last tick, quantized on the wire (VELOCITY_SCALE)
                 uint32_t score;
                 uint32_t last_processed_input_seq;  // appended by server
                 uint32_t last_processed_input_ts;   ///< Server-recorded client input timestamp (ms)
         };
 
+        /**
+         * @brief Velocity quantization: each component is sent as an int16 in 1/VELOCITY_SCALE units/s
+         *
+         * Resolution is 1/64 unit/s and the range is +-511 units/s, comfortably above player speed.
+         */
+        constexpr float VELOCITY_SCALE = 64.0f;
+
+        /**
+         * @brief Quantize one velocity component (round to nearest, saturate)
+         * @param v Component in units/s
+         * @return Wire value
+         */
+        inline int16_t quantize_velocity(float v)
+        {
+                float q = std::round(v * VELOCITY_SCALE);
+                return static_cast<int16_t>(std::clamp(q, -32767.0f, 32767.0f));
+        }
+
         /**
          * @struct CoinState
          * @brief Represents a coin's position in the game world
@@ -78,6 +102,43 @@ namespace protocol
                 float dx, dy;        ///< Movement direction vector (normalized)
                 uint32_t timestamp;  ///< Client timestamp when input was generated (ms)
                 uint32_t seq;        ///< Input sequence number for reconciliation
+                uint32_t ack_tick;   ///< Tick of the newest snapshot the client had received (0 if none)
+        };
+
+        /**
+         * @struct InputCommand
+         * @brief One input sampled by the client's fixed-rate input stream
+         * @note (0, 0) is an explicit stop; the stream sends it like any other command
+         */
+        struct InputCommand
+        {
+                float dx, dy;        ///< Movement direction
+                uint32_t timestamp;  ///< Client time the command was sampled (ms)
+        };
+
+        /**
+         * @struct InputBatchMessage
+         * @brief Input commands sent together in one write
+         * @note Followed by InputCommand[count]. The client samples one command per server tick, so
+         *       command i's sequence number first_seq + i is also its client input tick number.
+         */
+        struct InputBatchMessage
+        {
+                uint32_t first_seq;  ///< Sequence number (input tick) of the first command
+                uint32_t ack_tick;   ///< Tick of the newest snapshot the client had received (0 if none)
+                uint8_t count;       ///< Number of commands
+        };
+
+        /**
+         * @struct TimeSyncMessage
+         * @brief NTP-style timestamps for one clock sync exchange (all microseconds)
+         * @note Server times use the steady clock that stamps snapshots (timestamp = server_us / 1000)
+         */
+        struct TimeSyncMessage
+        {
+                uint64_t client_send_us;     ///< Client clock when the request was sent (echoed back)
+                uint64_t server_receive_us;  ///< Server clock when the request was processed
+                uint64_t server_send_us;     ///< Server clock when the response was queued
         };
 
         /**
@@ -88,6 +149,7 @@ namespace protocol
         struct GameStateMessage
         {
                 uint32_t timestamp;    ///< Server timestamp (ms)
+                uint32_t tick;         ///< Simulation tick the snapshot was taken after
                 uint8_t player_count;  ///< Number of players in the game
                 uint8_t coin_count;    ///< Number of active coins
         };
@@ -123,6 +185,12 @@ namespace protocol
                         std::memcpy(data.data() + start, &header, sizeof(MessageHeader));
                 }
 
+                /**
+                 * @brief Write 8-bit unsigned integer
+                 * @param value Value to write
+                 */
+                void write_uint8(uint8_t value) { data.push_back(value); }
+
                 /**
                  * @brief Write 32-bit unsigned integer
                  * @param value Value to write
@@ -134,6 +202,17 @@ namespace protocol
                         std::memcpy(data.data() + start, &value, sizeof(uint32_t));
                 }
 
+                /**
+                 * @brief Write 64-bit unsigned integer
+                 * @param value Value to write
+                 */
+                void write_uint64(uint64_t value)
+                {
+                        size_t start = data.size();
+                        data.resize(start + sizeof(uint64_t));
+                        std::memcpy(data.data() + start, &value, sizeof(uint64_t));
+                }
+
                 /**
                  * @brief Write 32-bit float
                  * @param value Value to write
@@ -155,6 +234,20 @@ namespace protocol
                         write_float(v.y);
                 }
 
+                /**
+                 * @brief Write a velocity quantized to two int16 (see VELOCITY_SCALE)
+                 * @param v Velocity in units/s; out-of-range components saturate
+                 */
+                void write_velocity(const Vec2& v)
+                {
+                        int16_t q[2];
+                        q[0]         = quantize_velocity(v.x);
+                        q[1]         = quantize_velocity(v.y);
+                        size_t start = data.size();
+                        data.resize(start + sizeof(q));
+                        std::memcpy(data.data() + start, q, sizeof(q));
+                }
+
                 /**
                  * @brief Write player state
                  * @param ps Player state to serialize
@@ -163,6 +256,7 @@ namespace protocol
                 {
                         write_uint32(ps.id);
                         write_vec2(ps.position);
+                        write_velocity(ps.velocity);
                         write_uint32(ps.score);
                         write_uint32(ps.last_processed_input_seq);
                         write_uint32(ps.last_processed_input_ts);
@@ -178,6 +272,17 @@ namespace protocol
                         write_vec2(cs.position);
                 }
 
+                /**
+                 * @brief Write input command
+                 * @param cmd Input command to serialize
+                 */
+                void write_input_command(const InputCommand& cmd)
+                {
+                        write_float(cmd.dx);
+                        write_float(cmd.dy);
+                        write_uint32(cmd.timestamp);
+                }
+
                 /**
                  * @brief Finalize message by updating header length
                  * @note Must be called after all data is written
@@ -224,6 +329,19 @@ namespace protocol
                         return true;
                 }
 
+                /**
+                 * @brief Read 8-bit unsigned integer
+                 * @param value Output value
+                 * @return true if successful, false on error
+                 */
+                bool read_uint8(uint8_t& value)
+                {
+                        if (offset + sizeof(uint8_t) > size)
+                                return false;
+                        value = data[offset++];
+                        return true;
+                }
+
                 /**
                  * @brief Read 32-bit unsigned integer
                  * @param value Output value
@@ -238,6 +356,20 @@ namespace protocol
                         return true;
                 }
 
+                /**
+                 * @brief Read 64-bit unsigned integer
+                 * @param value Output value
+                 * @return true if successful, false on error
+                 */
+                bool read_uint64(uint64_t& value)
+                {
+                        if (offset + sizeof(uint64_t) > size)
+                                return false;
+                        std::memcpy(&value, data + offset, sizeof(uint64_t));
+                        offset += sizeof(uint64_t);
+                        return true;
+                }
+
                 /**
                  * @brief Read 32-bit float
                  * @param value Output value
@@ -259,6 +391,23 @@ namespace protocol
                  */
                 bool read_vec2(Vec2& v) { return read_float(v.x) && read_float(v.y); }
 
+                /**
+                 * @brief Read a quantized velocity (see VELOCITY_SCALE)
+                 * @param v Output velocity in units/s
+                 * @return true if successful, false on error
+                 */
+                bool read_velocity(Vec2& v)
+                {
+                        int16_t q[2];
+                        if (offset + sizeof(q) > size)
+                                return false;
+                        std::memcpy(q, data + offset, sizeof(q));
+                        offset += sizeof(q);
+                        v.x     = static_cast<float>(q[0]) / VELOCITY_SCALE;
+                        v.y     = static_cast<float>(q[1]) / VELOCITY_SCALE;
+                        return true;
+                }
+
                 /**
                  * @brief Read player state
                  * @param ps Output player state
@@ -266,8 +415,9 @@ namespace protocol
                  */
                 bool read_player_state(PlayerState& ps)
                 {
-                        return read_uint32(ps.id) && read_vec2(ps.position) && read_uint32(ps.score) &&
-                               read_uint32(ps.last_processed_input_seq) && read_uint32(ps.last_processed_input_ts);
+                        return read_uint32(ps.id) && read_vec2(ps.position) && read_velocity(ps.velocity) &&
+                               read_uint32(ps.score) && read_uint32(ps.last_processed_input_seq) &&
+                               read_uint32(ps.last_processed_input_ts);
                 }
 
                 /**
@@ -276,6 +426,16 @@ namespace protocol
                  * @return true if successful, false on error
                  */
                 bool read_coin_state(CoinState& cs) { return read_uint32(cs.id) && read_vec2(cs.position); }
+
+                /**
+                 * @brief Read input command
+                 * @param cmd Output input command
+                 * @return true if successful, false on error
+                 */
+                bool read_input_command(InputCommand& cmd)
+                {
+                        return read_float(cmd.dx) && read_float(cmd.dy) && read_uint32(cmd.timestamp);
+                }
         };
 
 }  // namespace protocol
\ No newline at end of file
@@ -0,0 +1,105 @@
+/**
+ * @file spsc_queue.h
+ * @brief Bounded lock-free single-producer single-consumer queue with in-place slots
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * @class SpscQueue
+ * @brief Fixed-capacity ring between exactly one producer thread and one consumer thread
+ *
+ * Elements are built and consumed in place: the producer fills the slot returned
+ * by claim() and calls publish(); the consumer reads front() and calls pop().
+ * Slots are never destroyed, so an element that owns a buffer (a std::vector,
+ * say) keeps its capacity across laps and steady-state traffic does not allocate.
+ *
+ * Each side owns one index and reads the other's with acquire ordering; it also
+ * caches the last value it saw, so the shared cache line is only touched when
+ * the queue looks full (producer) or empty (consumer).
+ *
+ * @tparam T Element type (default constructible)
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+        /**
+         * @brief Construct queue
+         * @param capacity Minimum number of elements (rounded up to a power of two)
+         */
+        explicit SpscQueue(size_t capacity)
+        {
+                size_t cap = 2;
+                while (cap < capacity)
+                        cap <<= 1;
+
+                mask_  = cap - 1;
+                slots_ = std::make_unique<T[]>(cap);
+        }
+
+        SpscQueue(const SpscQueue&)            = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        /**
+         * @brief Get the next free slot (producer thread only)
+         * @return Slot to overwrite, or nullptr if the queue is full; the same slot until publish()
+         */
+        T* claim()
+        {
+                size_t tail = tail_.load(std::memory_order_relaxed);
+                if (tail - head_cache_ > mask_)
+                {
+                        head_cache_ = head_.load(std::memory_order_acquire);
+                        if (tail - head_cache_ > mask_)
+                                return nullptr;  // full
+                }
+                return &slots_[tail & mask_];
+        }
+
+        /**
+         * @brief Hand the claimed slot to the consumer (producer thread only)
+         */
+        void publish() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+        /**
+         * @brief Get the oldest published element (consumer thread only)
+         * @return Element, or nullptr if the queue is empty; valid until pop()
+         */
+        T* front()
+        {
+                size_t head = head_.load(std::memory_order_relaxed);
+                if (head == tail_cache_)
+                {
+                        tail_cache_ = tail_.load(std::memory_order_acquire);
+                        if (head == tail_cache_)
+                                return nullptr;  // empty
+                }
+                return &slots_[head & mask_];
+        }
+
+        /**
+         * @brief Release the front element's slot back to the producer (consumer thread only)
+         */
+        void pop() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+        /**
+         * @brief Get queue capacity
+         * @return Maximum number of elements the queue can hold
+         */
+        size_t capacity() const { return mask_ + 1; }
+
+private:
+        std::unique_ptr<T[]> slots_;
+        size_t mask_;
+
+        alignas(64) std::atomic<size_t> head_{0};  ///< Next slot to consume, written by the consumer
+        size_t tail_cache_ = 0;                    ///< Consumer's last view of tail_
+        alignas(64) std::atomic<size_t> tail_{0};  ///< Next slot to fill, written by the producer
+        size_t head_cache_ = 0;                    ///< Producer's last view of head_
+};
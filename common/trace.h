@@ -0,0 +1,231 @@
+/**
+ * @file trace.h
+ * @brief Scoped trace markers recorded per thread and exported as Chrome trace JSON
+ * @author NetworkGame Project
+ * @date 2024
+ *
+ * Usage:
+ * @code
+ * void GameSession::drain_inputs()
+ * {
+ *         TRACE_SCOPE("drain_inputs");
+ *         ...
+ * }
+ *
+ * trace::write_json("trace.json");  // open in chrome://tracing or ui.perfetto.dev
+ * @endcode
+ *
+ * Markers only record when the build defines ENABLE_TRACING (CMake option of the
+ * same name). Otherwise TRACE_SCOPE expands to nothing and write_json() returns
+ * false, so the markers can stay in release builds.
+ */
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace trace
+{
+        /**
+         * @struct Event
+         * @brief One completed scope ("X" event in the Chrome trace format)
+         */
+        struct Event
+        {
+                const char* name;   ///< Static string literal
+                uint64_t start_ns;  ///< Relative to the process trace epoch
+                uint64_t dur_ns;
+        };
+
+        /**
+         * @class ThreadBuffer
+         * @brief Fixed-size ring of events written by exactly one thread
+         *
+         * The owner writes a slot, then publishes it with a release store of head_.
+         * Readers copy the ring and keep only slots the owner cannot have
+         * overwritten while they were copying. No locks and no allocation on the
+         * recording path; the oldest events are overwritten once the ring is full.
+         */
+        class ThreadBuffer
+        {
+        public:
+                static constexpr size_t CAPACITY = 1 << 16;  ///< Events kept per thread (~1.5 MB)
+
+                ThreadBuffer(uint32_t tid, std::string name) : tid_(tid), name_(std::move(name)), events_(CAPACITY) {}
+
+                void push(const Event& e)
+                {
+                        uint64_t head                  = head_.load(std::memory_order_relaxed);
+                        events_[head & (CAPACITY - 1)] = e;
+                        head_.store(head + 1, std::memory_order_release);
+                }
+
+                /**
+                 * @brief Copy out the events currently held (safe from any thread)
+                 * @param out Appended with the retained events, oldest first
+                 */
+                void snapshot(std::vector<Event>& out) const
+                {
+                        uint64_t end   = head_.load(std::memory_order_acquire);
+                        uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+                        size_t first   = out.size();
+                        for (uint64_t i = begin; i < end; ++i)
+                                out.push_back(events_[i & (CAPACITY - 1)]);
+
+                        // Drop slots the owner may have overwritten during the copy (including the one
+                        // it may be writing right now, at index `after`)
+                        uint64_t after     = head_.load(std::memory_order_acquire);
+                        uint64_t safe_from = after + 1 > CAPACITY ? after + 1 - CAPACITY : 0;
+                        uint64_t torn      = safe_from > begin ? safe_from - begin : 0;
+                        torn               = torn > end - begin ? end - begin : torn;
+                        out.erase(out.begin() + static_cast<std::ptrdiff_t>(first),
+                                  out.begin() + static_cast<std::ptrdiff_t>(first + torn));
+                }
+
+                uint32_t tid() const { return tid_; }
+                const std::string& name() const { return name_; }
+                void set_name(std::string name) { name_ = std::move(name); }
+
+        private:
+                uint32_t tid_;
+                std::string name_;
+                std::vector<Event> events_;
+                std::atomic<uint64_t> head_{0};  ///< Total events ever pushed
+        };
+
+        /**
+         * @brief Process-wide registry of thread buffers (locked only on registration and export)
+         */
+        struct Registry
+        {
+                std::mutex mutex;
+                std::vector<std::unique_ptr<ThreadBuffer>> buffers;  ///< Never freed, so threads may exit freely
+                std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        };
+
+        inline Registry& registry()
+        {
+                static Registry r;
+                return r;
+        }
+
+        inline uint64_t now_ns()
+        {
+                auto elapsed = std::chrono::steady_clock::now() - registry().epoch;
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+
+        /**
+         * @brief Get (creating on first use) the calling thread's buffer
+         */
+        inline ThreadBuffer& this_thread_buffer()
+        {
+                thread_local ThreadBuffer* buffer = nullptr;
+                if (!buffer)
+                {
+                        Registry& r = registry();
+                        std::lock_guard<std::mutex> lock(r.mutex);
+                        uint32_t tid = static_cast<uint32_t>(r.buffers.size() + 1);
+                        r.buffers.push_back(std::make_unique<ThreadBuffer>(tid, "thread " + std::to_string(tid)));
+                        buffer = r.buffers.back().get();
+                }
+                return *buffer;
+        }
+
+        /**
+         * @brief Name the calling thread in exported traces
+         * @param name Thread name (e.g. "io", "log writer")
+         */
+        inline void set_thread_name(const char* name)
+        {
+#if defined(ENABLE_TRACING)
+                ThreadBuffer& buffer = this_thread_buffer();
+                std::lock_guard<std::mutex> lock(registry().mutex);
+                buffer.set_name(name);
+#else
+                (void)name;
+#endif
+        }
+
+        /**
+         * @class Scope
+         * @brief Records one event covering its own lifetime
+         */
+        class Scope
+        {
+        public:
+                explicit Scope(const char* name) : name_(name), start_ns_(now_ns()) {}
+                ~Scope() { this_thread_buffer().push(Event{name_, start_ns_, now_ns() - start_ns_}); }
+
+                Scope(const Scope&)            = delete;
+                Scope& operator=(const Scope&) = delete;
+
+        private:
+                const char* name_;
+                uint64_t start_ns_;
+        };
+
+        /**
+         * @brief Write every thread's retained events as Chrome trace-event JSON
+         * @param path Output file
+         * @return false if tracing is compiled out or the file cannot be written
+         * @note Safe to call while other threads keep recording
+         */
+        inline bool write_json(const std::string& path)
+        {
+#if defined(ENABLE_TRACING)
+                std::FILE* file = std::fopen(path.c_str(), "wb");
+                if (!file)
+                        return false;
+
+                std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", file);
+                bool first = true;
+
+                Registry& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                std::vector<Event> events;
+                for (const auto& buffer : r.buffers)
+                {
+                        std::fprintf(file,
+                                     "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                                     "\"args\":{\"name\":\"%s\"}}",
+                                     first ? "" : ",\n",
+                                     buffer->tid(),
+                                     buffer->name().c_str());
+                        first = false;
+
+                        events.clear();
+                        buffer->snapshot(events);
+                        for (const Event& e : events)
+                                std::fprintf(file,
+                                             ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                                             "\"ts\":%.3f,\"dur\":%.3f}",
+                                             e.name,
+                                             buffer->tid(),
+                                             static_cast<double>(e.start_ns) / 1000.0,
+                                             static_cast<double>(e.dur_ns) / 1000.0);
+                }
+
+                std::fputs("\n]}\n", file);
+                return std::fclose(file) == 0;
+#else
+                (void)path;
+                return false;
+#endif
+        }
+}  // namespace trace
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if defined(ENABLE_TRACING)
+#define TRACE_SCOPE(name) ::trace::Scope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,70 @@
+/**
+ * @file triple_buffer.h
+ * @brief Wait-free single-producer single-consumer "latest value" handoff
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class TripleBuffer
+ * @brief Three slots rotated with one atomic exchange per publish and per read
+ *
+ * The writer fills write_buffer() and calls publish(); the reader calls read()
+ * and gets the most recently published value. Neither side ever waits for the
+ * other or copies a T: the writer owns the back slot, the reader owns the front
+ * slot, and the middle slot changes hands through an atomic exchange. Values
+ * the reader never picked up are simply overwritten.
+ *
+ * The slot handed to the writer holds an older value, so the writer must
+ * overwrite it completely (clearing and refilling containers keeps their
+ * capacity, so steady-state publishing does not allocate).
+ *
+ * @tparam T Value type (default constructible)
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+        TripleBuffer() : back_(0), middle_(1), front_(2) {}
+
+        TripleBuffer(const TripleBuffer&)            = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+        /**
+         * @brief Get the slot to fill (writer thread only)
+         * @return Back slot; contents are stale
+         */
+        T& write_buffer() { return slots_[back_]; }
+
+        /**
+         * @brief Make the back slot the latest value (writer thread only)
+         */
+        void publish()
+        {
+                back_ = middle_.exchange(static_cast<uint8_t>(back_ | FRESH), std::memory_order_acq_rel) & INDEX_MASK;
+        }
+
+        /**
+         * @brief Get the latest published value (reader thread only)
+         * @return Front slot, valid until the next read()
+         */
+        const T& read()
+        {
+                if (middle_.load(std::memory_order_relaxed) & FRESH)
+                        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX_MASK;
+                return slots_[front_];
+        }
+
+private:
+        static constexpr uint8_t INDEX_MASK = 0x3;
+        static constexpr uint8_t FRESH      = 0x4;  ///< Set in middle_ when it holds an unread value
+
+        T slots_[3];
+        alignas(64) uint8_t back_;                 ///< Owned by the writer
+        alignas(64) std::atomic<uint8_t> middle_;  ///< Index of the handoff slot, plus FRESH
+        alignas(64) uint8_t front_;                ///< Owned by the reader
+};
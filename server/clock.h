@@ -0,0 +1,73 @@
+/**
+ * @file clock.h
+ * @brief Injectable time source for the simulation
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @class Clock
+ * @brief Millisecond time source read by the simulation
+ *
+ * GameSession never reads the system clock directly, so a run can be driven
+ * either by real time or by a virtual clock that jumps forward one tick at a
+ * time.
+ */
+class Clock
+{
+public:
+        virtual ~Clock() = default;
+
+        /**
+         * @brief Get the current time
+         * @return Milliseconds since an arbitrary epoch
+         */
+        virtual uint32_t now_ms() const = 0;
+};
+
+/**
+ * @class SteadyClock
+ * @brief Wall-clock time from std::chrono::steady_clock
+ */
+class SteadyClock : public Clock
+{
+public:
+        uint32_t now_ms() const override
+        {
+                return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                 std::chrono::steady_clock::now().time_since_epoch())
+                                                 .count());
+        }
+};
+
+/**
+ * @class VirtualClock
+ * @brief Manually advanced time, for fast-forwarded and reproducible runs
+ *
+ * Time is kept in microseconds so advancing by a non-integral number of
+ * milliseconds per tick (16.67 ms at 60 Hz) does not drift.
+ */
+class VirtualClock : public Clock
+{
+public:
+        /**
+         * @brief Construct virtual clock
+         * @param start_ms Initial time in milliseconds
+         */
+        explicit VirtualClock(uint32_t start_ms = 0) : now_us_(static_cast<uint64_t>(start_ms) * 1000) {}
+
+        uint32_t now_ms() const override { return static_cast<uint32_t>(now_us_ / 1000); }
+
+        /**
+         * @brief Move time forward
+         * @param us Microseconds to advance
+         */
+        void advance_us(uint64_t us) { now_us_ += us; }
+
+private:
+        uint64_t now_us_;  ///< Current virtual time (microseconds)
+};
@@ -0,0 +1,248 @@
+/**
+ * @file entity_store.h
+ * @brief Dense structure-of-arrays storage for players and coins
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include "protocol.h"
+#include "input_queue.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class EntityIndex
+ * @brief Sparse entity ID to dense array index map
+ *
+ * Only consulted when an entity is added, removed or addressed by ID; hot loops
+ * walk the dense arrays directly.
+ */
+class EntityIndex
+{
+public:
+        static constexpr uint32_t NPOS = UINT32_MAX;  ///< Returned by find() for unknown IDs
+
+        /**
+         * @brief Look up an entity's dense index
+         * @param id Entity ID
+         * @return Dense index, or NPOS if the entity does not exist
+         */
+        uint32_t find(uint32_t id) const
+        {
+                auto it = map_.find(id);
+                return it == map_.end() ? NPOS : it->second;
+        }
+
+        /**
+         * @brief Set an entity's dense index
+         * @param id Entity ID
+         * @param index Dense index
+         */
+        void set(uint32_t id, uint32_t index) { map_[id] = index; }
+
+        /**
+         * @brief Forget an entity
+         * @param id Entity ID
+         */
+        void erase(uint32_t id) { map_.erase(id); }
+
+private:
+        std::unordered_map<uint32_t, uint32_t> map_;
+};
+
+namespace detail
+{
+        /**
+         * @brief Remove element i by moving the last element into its slot
+         */
+        template <typename T>
+        void swap_remove(std::vector<T>& v, size_t i)
+        {
+                if (i + 1 != v.size())
+                        v[i] = std::move(v.back());
+                v.pop_back();
+        }
+}  // namespace detail
+
+/**
+ * @class PlayerStore
+ * @brief Players stored as parallel arrays indexed by a dense slot
+ *
+ * Removal swaps the last player into the freed slot, so iteration order is a
+ * deterministic function of the add/remove history (identical on replay).
+ */
+class PlayerStore
+{
+public:
+        std::vector<uint32_t> id;              ///< Player IDs
+        std::vector<float> x;                  ///< Position X
+        std::vector<float> y;                  ///< Position Y
+        std::vector<float> vx;                 ///< Velocity X over the last tick (units/s, sent in snapshots)
+        std::vector<float> vy;                 ///< Velocity Y over the last tick
+        std::vector<uint32_t> score;           ///< Coins collected
+        std::vector<uint32_t> last_input_seq;  ///< Last consumed input sequence (acked to the client)
+        std::vector<uint32_t> last_input_ts;   ///< Client timestamp of the last consumed input
+        std::vector<uint8_t> pickup_deferred;  ///< 1 while overlapping a coin the client had not seen yet
+        std::vector<PlayerInputQueue> inputs;  ///< Inputs waiting to be consumed by the tick
+
+        /**
+         * @brief Add a player
+         * @param player_id Player ID
+         * @param pos Spawn position
+         * @return Dense index of the new player
+         */
+        uint32_t add(uint32_t player_id, const protocol::Vec2& pos)
+        {
+                uint32_t i = static_cast<uint32_t>(id.size());
+                id.push_back(player_id);
+                x.push_back(pos.x);
+                y.push_back(pos.y);
+                vx.push_back(0.0f);
+                vy.push_back(0.0f);
+                score.push_back(0);
+                last_input_seq.push_back(0);
+                last_input_ts.push_back(0);
+                pickup_deferred.push_back(0);
+                inputs.emplace_back();
+                index_.set(player_id, i);
+                return i;
+        }
+
+        /**
+         * @brief Remove a player (swap-and-pop)
+         * @param player_id Player ID
+         * @return true if the player existed
+         */
+        bool remove(uint32_t player_id)
+        {
+                uint32_t i = index_.find(player_id);
+                if (i == EntityIndex::NPOS)
+                        return false;
+
+                uint32_t last = static_cast<uint32_t>(id.size() - 1);
+                if (i != last)
+                        index_.set(id[last], i);
+                index_.erase(player_id);
+
+                detail::swap_remove(id, i);
+                detail::swap_remove(x, i);
+                detail::swap_remove(y, i);
+                detail::swap_remove(vx, i);
+                detail::swap_remove(vy, i);
+                detail::swap_remove(score, i);
+                detail::swap_remove(last_input_seq, i);
+                detail::swap_remove(last_input_ts, i);
+                detail::swap_remove(pickup_deferred, i);
+                detail::swap_remove(inputs, i);
+                return true;
+        }
+
+        /**
+         * @brief Find a player's dense index
+         * @param player_id Player ID
+         * @return Dense index, or EntityIndex::NPOS
+         */
+        uint32_t find(uint32_t player_id) const { return index_.find(player_id); }
+
+        /**
+         * @brief Get a player's position
+         * @param i Dense index
+         * @return Position
+         */
+        protocol::Vec2 position(uint32_t i) const { return protocol::Vec2(x[i], y[i]); }
+
+        /**
+         * @brief Get a player's velocity over the last tick
+         * @param i Dense index
+         * @return Velocity in units/s
+         */
+        protocol::Vec2 velocity(uint32_t i) const { return protocol::Vec2(vx[i], vy[i]); }
+
+        /**
+         * @brief Get number of players
+         * @return Player count
+         */
+        size_t size() const { return id.size(); }
+
+private:
+        EntityIndex index_;
+};
+
+/**
+ * @class CoinStore
+ * @brief Coins stored as parallel arrays indexed by a dense slot
+ */
+class CoinStore
+{
+public:
+        std::vector<uint32_t> id;          ///< Coin IDs
+        std::vector<float> x;              ///< Position X
+        std::vector<float> y;              ///< Position Y
+        std::vector<uint64_t> spawn_tick;  ///< First tick whose snapshot shows the coin
+
+        /**
+         * @brief Add a coin
+         * @param coin_id Coin ID
+         * @param pos Coin position
+         * @param shown_tick First tick whose snapshot shows the coin
+         * @return Dense index of the new coin
+         */
+        uint32_t add(uint32_t coin_id, const protocol::Vec2& pos, uint64_t shown_tick)
+        {
+                uint32_t i = static_cast<uint32_t>(id.size());
+                id.push_back(coin_id);
+                x.push_back(pos.x);
+                y.push_back(pos.y);
+                spawn_tick.push_back(shown_tick);
+                index_.set(coin_id, i);
+                return i;
+        }
+
+        /**
+         * @brief Remove a coin (swap-and-pop)
+         * @param coin_id Coin ID
+         * @return true if the coin existed
+         */
+        bool remove(uint32_t coin_id)
+        {
+                uint32_t i = index_.find(coin_id);
+                if (i == EntityIndex::NPOS)
+                        return false;
+
+                uint32_t last = static_cast<uint32_t>(id.size() - 1);
+                if (i != last)
+                        index_.set(id[last], i);
+                index_.erase(coin_id);
+
+                detail::swap_remove(id, i);
+                detail::swap_remove(x, i);
+                detail::swap_remove(y, i);
+                detail::swap_remove(spawn_tick, i);
+                return true;
+        }
+
+        /**
+         * @brief Find a coin's dense index
+         * @param coin_id Coin ID
+         * @return Dense index, or EntityIndex::NPOS
+         */
+        uint32_t find(uint32_t coin_id) const { return index_.find(coin_id); }
+
+        /**
+         * @brief Get a coin's position
+         * @param i Dense index
+         * @return Position
+         */
+        protocol::Vec2 position(uint32_t i) const { return protocol::Vec2(x[i], y[i]); }
+
+        /**
+         * @brief Get number of coins
+         * @return Coin count
+         */
+        size_t size() const { return id.size(); }
+
+private:
+        EntityIndex index_;
+};
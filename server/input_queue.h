@@ -0,0 +1,81 @@
+/**
+ * @file input_queue.h
+ * @brief Per-player input queue consumed one entry per simulation tick
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include "protocol.h"
+#include <array>
+#include <cstddef>
+
+/**
+ * @class PlayerInputQueue
+ * @brief Fixed-capacity FIFO of pending inputs for a single player
+ *
+ * The simulation consumes exactly one input per player per tick. When a client
+ * sends faster than the tick rate the queue grows up to CAPACITY, after which the
+ * oldest input is discarded so that buffered latency stays bounded. When the queue
+ * runs dry the player idles for that tick. Clients stream one command per tick,
+ * explicit stops included, so a late command is applied on a later tick rather
+ * than guessed: every command moves the player exactly once, which is what
+ * client prediction assumes.
+ */
+class PlayerInputQueue
+{
+public:
+        static constexpr size_t CAPACITY = 8;  ///< Max buffered inputs (~133ms at 60Hz)
+
+        /**
+         * @brief Queue a new input
+         * @param input Input received from the client
+         * @note Drops the oldest buffered input if the queue is full
+         */
+        void push(const protocol::ClientInput& input)
+        {
+                if (count_ == CAPACITY)
+                {
+                        head_ = (head_ + 1) % CAPACITY;
+                        --count_;
+                }
+                buffer_[(head_ + count_) % CAPACITY] = input;
+                ++count_;
+        }
+
+        /**
+         * @brief Select the input to simulate this tick
+         * @param out Input to apply (zero movement if the player is idle)
+         * @return true if a fresh input was consumed, false if an idle input was produced
+         */
+        bool consume(protocol::ClientInput& out)
+        {
+                if (count_ > 0)
+                {
+                        out   = buffer_[head_];
+                        head_ = (head_ + 1) % CAPACITY;
+                        --count_;
+                        last_ = out;
+                        return true;
+                }
+
+                // Missing input: stand still (keeping the last input's seq and ack_tick)
+                out    = last_;
+                out.dx = 0.0f;
+                out.dy = 0.0f;
+                return false;
+        }
+
+        /**
+         * @brief Get number of buffered inputs
+         * @return Queue depth
+         */
+        size_t size() const { return count_; }
+
+private:
+        std::array<protocol::ClientInput, CAPACITY> buffer_{};
+        size_t head_  = 0;
+        size_t count_ = 0;
+
+        protocol::ClientInput last_{};  ///< Last consumed input, used when the queue is starved
+};
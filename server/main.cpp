@@ -6,26 +6,153 @@
  */
 
 #include "server.h"
+#include "simulator.h"
+#include "trace.h"
+#include "log.h"
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
+/**
+ * @brief Run a headless match in virtual time and report throughput
+ * @param seconds Simulated match length
+ * @param players Number of scripted players
+ * @param seed Seed for the session and the input script
+ * @param record_path Match log output path (empty = no recording)
+ * @param trace_path Chrome trace output path, written when the run ends (empty = none)
+ * @param snapshot_rate Snapshots serialized per simulated second
+ * @return 0
+ */
+static int run_simulation(uint32_t seconds,
+                          uint32_t players,
+                          uint32_t seed,
+                          const std::string& record_path,
+                          const std::string& trace_path,
+                          uint32_t snapshot_rate)
+{
+        Simulator sim(seed, record_path.empty() ? nullptr : std::make_shared<MatchLog>(record_path, seed));
+        for (uint32_t id = 1; id <= players; ++id)
+                sim.add_player(id);
+
+        Simulator::Result result = sim.run(static_cast<uint64_t>(seconds) * GameSession::TICK_RATE,
+                                           Simulator::random_walk(seed),
+                                           GameSession::broadcast_interval_ticks(snapshot_rate));
+        logging::logger().flush();
+
+        std::cout << "Simulated " << result.ticks << " ticks (" << seconds << " s, " << players << " players, seed "
+                  << seed << ") in " << result.wall_seconds << " s: " << result.ticks_per_second() << " ticks/s, "
+                  << result.snapshot_bytes << " snapshot bytes\n"
+                  << "State hash: " << std::hex << result.state_hash << std::dec << "\n";
+
+        if (!trace_path.empty() && trace::write_json(trace_path))
+                std::cout << "Wrote trace to " << trace_path << "\n";
+        return 0;
+}
+
+/**
+ * @brief Parse a --log-level value
+ * @param name debug, info, warn or error
+ * @return Level (info for anything unrecognised)
+ */
+static logging::Level parse_log_level(const char* name)
+{
+        if (std::strcmp(name, "debug") == 0)
+                return logging::Level::DEBUG;
+        if (std::strcmp(name, "warn") == 0)
+                return logging::Level::WARN;
+        if (std::strcmp(name, "error") == 0)
+                return logging::Level::ERR;
+        return logging::Level::INFO;
+}
+
 /**
  * @brief Main server application
  * @param argc Argument count
- * @param argv Arguments: [port]
+ * @param argv Arguments: [port] [--seed N] [--record FILE] [--metrics-port N] [--trace FILE] [--snapshot-rate HZ]
+ *             [--log-level debug|info|warn|error] [--log-file FILE] [--log-binary FILE]
+ *             [--simulate SECONDS [--players N]]
  * @return 0 on success, 1 on error
  */
 int main(int argc, char* argv[])
 {
         try
         {
-                uint16_t port = 12345;
-                if (argc > 1)
+                uint16_t port          = 12345;
+                uint32_t seed          = 0;
+                bool seeded            = false;
+                uint32_t sim_seconds   = 0;
+                uint32_t sim_players   = 4;
+                uint16_t metrics_port  = 0;
+                uint32_t snapshot_rate = 20;
+                std::string record_path;
+                std::string trace_path;
+
+                for (int i = 1; i < argc; ++i)
                 {
-                        port = static_cast<uint16_t>(std::atoi(argv[1]));
+                        if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+                        {
+                                seed   = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+                                seeded = true;
+                        }
+                        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+                        {
+                                record_path = argv[++i];
+                        }
+                        else if (std::strcmp(argv[i], "--log-level") == 0 && i + 1 < argc)
+                        {
+                                logging::logger().set_level(parse_log_level(argv[++i]));
+                        }
+                        else if (std::strcmp(argv[i], "--log-file") == 0 && i + 1 < argc)
+                        {
+                                logging::logger().set_sink(std::make_unique<logging::TextSink>(std::string(argv[++i])));
+                        }
+                        else if (std::strcmp(argv[i], "--log-binary") == 0 && i + 1 < argc)
+                        {
+                                logging::logger().set_sink(std::make_unique<logging::BinarySink>(argv[++i]));
+                        }
+                        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+                        {
+                                trace_path = argv[++i];
+                        }
+                        else if (std::strcmp(argv[i], "--metrics-port") == 0 && i + 1 < argc)
+                        {
+                                metrics_port = static_cast<uint16_t>(std::atoi(argv[++i]));
+                        }
+                        else if (std::strcmp(argv[i], "--snapshot-rate") == 0 && i + 1 < argc)
+                        {
+                                snapshot_rate = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+                        }
+                        else if (std::strcmp(argv[i], "--simulate") == 0 && i + 1 < argc)
+                        {
+                                sim_seconds = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+                        }
+                        else if (std::strcmp(argv[i], "--players") == 0 && i + 1 < argc)
+                        {
+                                sim_players = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+                        }
+                        else
+                        {
+                                port = static_cast<uint16_t>(std::atoi(argv[i]));
+                        }
                 }
 
+                if (sim_seconds > 0)
+                        return run_simulation(sim_seconds,
+                                              sim_players,
+                                              seeded ? seed : 1,
+                                              record_path,
+                                              trace_path,
+                                              snapshot_rate);
+
                 asio::io_context io;
-                GameServer server(io, port);
+                GameServer server(io, port, seeded ? seed : std::random_device{}());
+                if (!record_path.empty())
+                        server.record_match(record_path);
+                if (metrics_port != 0)
+                        server.serve_metrics(metrics_port);
+                server.set_snapshot_rate(snapshot_rate);
+                if (!trace_path.empty())
+                        server.trace_to(trace_path);
                 server.start();
 
                 std::cout << "Server running. Press Ctrl+C to stop.\n";
@@ -0,0 +1,178 @@
+#include "match_log.h"
+#include <cstring>
+#include <stdexcept>
+
+MatchLog::MatchLog(const std::string& path, uint32_t seed)
+    : ticks_buffered_(0),
+      stopping_(false),
+      file_(std::fopen(path.c_str(), "wb"))
+{
+        if (!file_)
+                throw std::runtime_error("Cannot open match log " + path);
+
+        buffer_.reserve(FLUSH_BYTES + 256);
+        put(match_log::MAGIC, sizeof(match_log::MAGIC));
+        put_u32(match_log::VERSION);
+        put_u32(seed);
+
+        writer_ = std::thread([this]() { writer_loop(); });
+}
+
+MatchLog::~MatchLog()
+{
+        flush();
+        {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+        }
+        cv_.notify_one();
+        writer_.join();
+        std::fclose(file_);
+}
+
+void MatchLog::start(uint32_t tick)
+{
+        put_u8(static_cast<uint8_t>(match_log::RecordType::START));
+        put_u32(tick);
+}
+
+void MatchLog::join(uint32_t tick, uint32_t player_id)
+{
+        put_u8(static_cast<uint8_t>(match_log::RecordType::JOIN));
+        put_u32(tick);
+        put_u32(player_id);
+}
+
+void MatchLog::leave(uint32_t tick, uint32_t player_id)
+{
+        put_u8(static_cast<uint8_t>(match_log::RecordType::LEAVE));
+        put_u32(tick);
+        put_u32(player_id);
+}
+
+void MatchLog::input(uint32_t player_id, const protocol::ClientInput& input)
+{
+        put_u8(static_cast<uint8_t>(match_log::RecordType::INPUT));
+        put_u32(player_id);
+        put_f32(input.dx);
+        put_f32(input.dy);
+        put_u32(input.timestamp);
+        put_u32(input.seq);
+        put_u32(input.ack_tick);
+}
+
+void MatchLog::end_tick(uint32_t tick, uint64_t hash)
+{
+        put_u8(static_cast<uint8_t>(match_log::RecordType::TICK));
+        put_u32(tick);
+        put_u64(hash);
+
+        if (buffer_.size() >= FLUSH_BYTES || ++ticks_buffered_ >= FLUSH_TICKS)
+                flush();
+}
+
+void MatchLog::flush()
+{
+        ticks_buffered_ = 0;
+        if (buffer_.empty())
+                return;
+
+        {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pending_.push_back(std::move(buffer_));
+                buffer_.clear();
+                if (!spare_.empty())
+                {
+                        buffer_ = std::move(spare_.back());
+                        spare_.pop_back();
+                }
+        }
+        cv_.notify_one();
+
+        buffer_.reserve(FLUSH_BYTES + 256);
+}
+
+void MatchLog::put(const void* data, size_t size)
+{
+        size_t start = buffer_.size();
+        buffer_.resize(start + size);
+        std::memcpy(buffer_.data() + start, data, size);
+}
+
+void MatchLog::writer_loop()
+{
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;)
+        {
+                cv_.wait(lock, [this]() { return stopping_ || !pending_.empty(); });
+                if (pending_.empty())
+                        break;
+
+                std::vector<uint8_t> chunk = std::move(pending_.front());
+                pending_.pop_front();
+
+                // Disk I/O happens outside the lock so flush() never waits on it
+                lock.unlock();
+                std::fwrite(chunk.data(), 1, chunk.size(), file_);
+                std::fflush(file_);
+                chunk.clear();
+                lock.lock();
+
+                spare_.push_back(std::move(chunk));
+        }
+}
+
+MatchLogReader::MatchLogReader(const std::string& path) : offset_(0), seed_(0)
+{
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file)
+                throw std::runtime_error("Cannot open match log " + path);
+
+        uint8_t chunk[64 * 1024];
+        size_t n;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+                data_.insert(data_.end(), chunk, chunk + n);
+        std::fclose(file);
+
+        char magic[sizeof(match_log::MAGIC)];
+        uint32_t version = 0;
+        if (!get(magic, sizeof(magic)) || std::memcmp(magic, match_log::MAGIC, sizeof(magic)) != 0 ||
+            !get(&version, sizeof(version)) || version != match_log::VERSION || !get(&seed_, sizeof(seed_)))
+                throw std::runtime_error("Not a match log (or unsupported version): " + path);
+}
+
+bool MatchLogReader::next(match_log::Record& out)
+{
+        uint8_t type;
+        if (!get(&type, sizeof(type)))
+                return false;
+
+        out      = match_log::Record{};
+        out.type = static_cast<match_log::RecordType>(type);
+        switch (out.type)
+        {
+        case match_log::RecordType::START:
+                return get(&out.tick, sizeof(out.tick));
+        case match_log::RecordType::JOIN:
+        case match_log::RecordType::LEAVE:
+                return get(&out.tick, sizeof(out.tick)) && get(&out.player_id, sizeof(out.player_id));
+        case match_log::RecordType::INPUT:
+                return get(&out.player_id, sizeof(out.player_id)) && get(&out.input.dx, sizeof(out.input.dx)) &&
+                       get(&out.input.dy, sizeof(out.input.dy)) &&
+                       get(&out.input.timestamp, sizeof(out.input.timestamp)) &&
+                       get(&out.input.seq, sizeof(out.input.seq)) &&
+                       get(&out.input.ack_tick, sizeof(out.input.ack_tick));
+        case match_log::RecordType::TICK:
+                return get(&out.tick, sizeof(out.tick)) && get(&out.hash, sizeof(out.hash));
+        }
+        return false;
+}
+
+bool MatchLogReader::get(void* out, size_t size)
+{
+        if (offset_ + size > data_.size())
+                return false;
+        std::memcpy(out, data_.data() + offset_, size);
+        offset_ += size;
+        return true;
+}
@@ -0,0 +1,198 @@
+/**
+ * @file match_log.h
+ * @brief Compact binary match recording with a background writer, and its reader
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include "protocol.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @namespace match_log
+ * @brief On-disk format shared by MatchLog and MatchLogReader
+ *
+ * File: MAGIC (4 bytes), VERSION (uint32), seed (uint32), then records.
+ * Each record is a one-byte RecordType followed by its fields in host byte order:
+ *
+ * - START:  tick
+ * - JOIN:   tick, player_id
+ * - LEAVE:  tick, player_id
+ * - INPUT:  player_id, dx, dy, timestamp, seq, ack_tick (applies to the next TICK)
+ * - TICK:   tick (after increment), state hash (uint64)
+ *
+ * INPUT records are the inputs a tick drained into the player queues, so
+ * replaying them through GameSession::push_input() reproduces the exact
+ * per-player consumption, including idle ticks.
+ */
+namespace match_log
+{
+        constexpr char MAGIC[4]   = {'N', 'G', 'M', 'L'};
+        constexpr uint32_t VERSION = 2;  ///< 2: starved input queues idle instead of repeating the last input
+
+        /**
+         * @enum RecordType
+         * @brief Kind of a log record
+         */
+        enum class RecordType : uint8_t
+        {
+                START = 1,
+                JOIN  = 2,
+                LEAVE = 3,
+                INPUT = 4,
+                TICK  = 5
+        };
+
+        /**
+         * @struct Record
+         * @brief Decoded log record (fields not used by a type are zero)
+         */
+        struct Record
+        {
+                RecordType type;
+                uint32_t tick;
+                uint32_t player_id;
+                protocol::ClientInput input;
+                uint64_t hash;
+        };
+}  // namespace match_log
+
+/**
+ * @class MatchLog
+ * @brief Appends match records to a file without blocking the caller on disk I/O
+ *
+ * Records are encoded into an in-memory buffer owned by the tick thread. Once it
+ * passes FLUSH_BYTES, or every FLUSH_TICKS ticks, the buffer is handed to a
+ * background thread under a short lock (a vector move) and the tick thread
+ * continues with a recycled buffer. The destructor hands over whatever is left
+ * and waits for the writer to finish.
+ */
+class MatchLog
+{
+public:
+        static constexpr size_t FLUSH_BYTES   = 64 * 1024;  ///< Buffer size that triggers a hand-off
+        static constexpr uint32_t FLUSH_TICKS = 60;         ///< Hand off at least this often (bounds loss on a crash)
+
+        /**
+         * @brief Create the log file and write its header
+         * @param path Output file path
+         * @param seed Session RNG seed
+         * @throws std::runtime_error if the file cannot be opened
+         */
+        MatchLog(const std::string& path, uint32_t seed);
+
+        /**
+         * @brief Flush remaining records and stop the writer thread
+         */
+        ~MatchLog();
+
+        MatchLog(const MatchLog&)            = delete;
+        MatchLog& operator=(const MatchLog&) = delete;
+
+        /**
+         * @brief Record the session starting
+         * @param tick Current tick
+         */
+        void start(uint32_t tick);
+
+        /**
+         * @brief Record a player joining
+         * @param tick Current tick
+         * @param player_id Player ID
+         */
+        void join(uint32_t tick, uint32_t player_id);
+
+        /**
+         * @brief Record a player leaving
+         * @param tick Current tick
+         * @param player_id Player ID
+         */
+        void leave(uint32_t tick, uint32_t player_id);
+
+        /**
+         * @brief Record an input drained by the upcoming tick
+         * @param player_id Player ID
+         * @param input Input as queued
+         */
+        void input(uint32_t player_id, const protocol::ClientInput& input);
+
+        /**
+         * @brief Record the end of a tick
+         * @param tick Tick counter after the tick
+         * @param hash State hash after the tick
+         */
+        void end_tick(uint32_t tick, uint64_t hash);
+
+        /**
+         * @brief Hand buffered records to the writer thread now
+         */
+        void flush();
+
+private:
+        void put_u8(uint8_t v) { buffer_.push_back(v); }
+        void put_u32(uint32_t v) { put(&v, sizeof(v)); }
+        void put_u64(uint64_t v) { put(&v, sizeof(v)); }
+        void put_f32(float v) { put(&v, sizeof(v)); }
+        void put(const void* data, size_t size);
+        void writer_loop();
+
+        std::vector<uint8_t> buffer_;  ///< Records being encoded (tick thread only)
+        uint32_t ticks_buffered_;      ///< Ticks recorded since the last hand-off
+
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::deque<std::vector<uint8_t>> pending_;  ///< Buffers waiting to be written
+        std::vector<std::vector<uint8_t>> spare_;   ///< Written buffers kept for reuse
+        bool stopping_;
+        FILE* file_;
+        std::thread writer_;
+};
+
+/**
+ * @class MatchLogReader
+ * @brief Sequential decoder for files written by MatchLog
+ */
+class MatchLogReader
+{
+public:
+        /**
+         * @brief Load a log file
+         * @param path File path
+         * @throws std::runtime_error if the file cannot be read or has a bad header
+         */
+        explicit MatchLogReader(const std::string& path);
+
+        /**
+         * @brief Get the session seed from the header
+         * @return Seed
+         */
+        uint32_t seed() const { return seed_; }
+
+        /**
+         * @brief Decode the next record
+         * @param out Decoded record
+         * @return false at end of file or on a truncated record
+         */
+        bool next(match_log::Record& out);
+
+        /**
+         * @brief Get file size
+         * @return Bytes
+         */
+        size_t size() const { return data_.size(); }
+
+private:
+        bool get(void* out, size_t size);
+
+        std::vector<uint8_t> data_;
+        size_t offset_;
+        uint32_t seed_;
+};
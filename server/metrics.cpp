@@ -0,0 +1,66 @@
+#include "metrics.h"
+#include <cstdio>
+#include <stdexcept>
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const std::string& labels)
+{
+        std::lock_guard<std::mutex> lock(mutex_);
+        Counter& c = counters_.emplace_back();
+        family(name, help, true).series.push_back(Series{labels, &c, nullptr});
+        return c;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const std::string& labels)
+{
+        std::lock_guard<std::mutex> lock(mutex_);
+        Gauge& g = gauges_.emplace_back();
+        family(name, help, false).series.push_back(Series{labels, nullptr, &g});
+        return g;
+}
+
+MetricsRegistry::Family& MetricsRegistry::family(const std::string& name, const std::string& help, bool is_counter)
+{
+        for (Family& f : families_)
+        {
+                if (f.name == name)
+                {
+                        if (f.is_counter != is_counter)
+                                throw std::logic_error("Metric " + name + " registered as both counter and gauge");
+                        return f;
+                }
+        }
+
+        families_.push_back(Family{name, help, is_counter, {}});
+        return families_.back();
+}
+
+std::string MetricsRegistry::render() const
+{
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::string out;
+        out.reserve(4096);
+        char value[64];
+        for (const Family& f : families_)
+        {
+                out += "# HELP " + f.name + " " + f.help + "\n";
+                out += "# TYPE " + f.name + (f.is_counter ? " counter\n" : " gauge\n");
+
+                for (const Series& s : f.series)
+                {
+                        if (s.counter)
+                                std::snprintf(value, sizeof(value), "%llu",
+                                              static_cast<unsigned long long>(s.counter->value()));
+                        else
+                                std::snprintf(value, sizeof(value), "%.9g", s.gauge->value());
+
+                        out += f.name;
+                        if (!s.labels.empty())
+                                out += "{" + s.labels + "}";
+                        out += " ";
+                        out += value;
+                        out += "\n";
+                }
+        }
+        return out;
+}
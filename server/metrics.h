@@ -0,0 +1,113 @@
+/**
+ * @file metrics.h
+ * @brief Lock-free counters and gauges with Prometheus text exposition
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class Counter
+ * @brief Monotonically increasing value; inc() is one relaxed atomic add
+ */
+class Counter
+{
+public:
+        void inc(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+        uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+        std::atomic<uint64_t> value_{0};
+};
+
+/**
+ * @class Gauge
+ * @brief Value that can go up and down; set() is one relaxed atomic store
+ */
+class Gauge
+{
+public:
+        void set(double v) { value_.store(v, std::memory_order_relaxed); }
+
+        void add(double delta)
+        {
+                double current = value_.load(std::memory_order_relaxed);
+                while (!value_.compare_exchange_weak(current, current + delta, std::memory_order_relaxed))
+                {
+                }
+        }
+
+        double value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+        std::atomic<double> value_{0.0};
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief Owns named metrics and renders them in the Prometheus text format
+ *
+ * Register everything at startup and keep the returned references: updating a
+ * metric never touches the registry, only the metric's own atomic. Metrics have
+ * stable addresses for the registry's lifetime.
+ *
+ * render() takes the registry mutex, which only registration also takes, so a
+ * scrape can never block a thread that is updating metrics.
+ */
+class MetricsRegistry
+{
+public:
+        /**
+         * @brief Register a counter series
+         * @param name Metric family name (e.g. game_bytes_sent_total)
+         * @param help One-line description, emitted once per family
+         * @param labels Label set without braces (e.g. type="client_input"), empty for none
+         * @return Counter owned by the registry
+         */
+        Counter& counter(const std::string& name, const std::string& help, const std::string& labels = "");
+
+        /**
+         * @brief Register a gauge series
+         * @param name Metric family name
+         * @param help One-line description, emitted once per family
+         * @param labels Label set without braces, empty for none
+         * @return Gauge owned by the registry
+         */
+        Gauge& gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+
+        /**
+         * @brief Render every metric in Prometheus text exposition format 0.0.4
+         * @return Response body
+         */
+        std::string render() const;
+
+private:
+        struct Series
+        {
+                std::string labels;
+                const Counter* counter;  ///< Exactly one of counter/gauge is set
+                const Gauge* gauge;
+        };
+
+        struct Family
+        {
+                std::string name;
+                std::string help;
+                bool is_counter;
+                std::vector<Series> series;
+        };
+
+        Family& family(const std::string& name, const std::string& help, bool is_counter);
+
+        mutable std::mutex mutex_;      ///< Guards families_ and the metric deques
+        std::vector<Family> families_;
+        std::deque<Counter> counters_;  ///< deque keeps addresses stable as metrics are added
+        std::deque<Gauge> gauges_;      ///< deque keeps addresses stable as metrics are added
+};
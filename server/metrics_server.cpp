@@ -0,0 +1,100 @@
+#include "metrics_server.h"
+#include <istream>
+#include <memory>
+#include <string>
+
+namespace
+{
+        /**
+         * @struct Exchange
+         * @brief State of one scrape request, kept alive by its pending handlers
+         */
+        struct Exchange
+        {
+                Exchange(asio::ip::tcp::socket s, size_t max_request)
+                    : socket(std::move(s)), request(max_request), timer(socket.get_executor())
+                {
+                }
+
+                asio::ip::tcp::socket socket;
+                asio::streambuf request;
+                asio::steady_timer timer;
+                std::string response;
+        };
+
+        std::string http_response(const char* status, const char* content_type, const std::string& body)
+        {
+                return std::string("HTTP/1.1 ") + status + "\r\nContent-Type: " + content_type +
+                       "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+        }
+}  // namespace
+
+MetricsServer::MetricsServer(asio::io_context& io, uint16_t port, const MetricsRegistry& registry)
+    : acceptor_(io, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), port)), registry_(registry)
+{
+}
+
+void MetricsServer::start()
+{
+        accept();
+}
+
+void MetricsServer::accept()
+{
+        acceptor_.async_accept(
+            [this](asio::error_code ec, asio::ip::tcp::socket socket)
+            {
+                    if (!ec)
+                            handle(std::move(socket));
+                    if (ec != asio::error::operation_aborted)
+                            accept();
+            });
+}
+
+void MetricsServer::handle(asio::ip::tcp::socket socket)
+{
+        auto ex = std::make_shared<Exchange>(std::move(socket), MAX_REQUEST_BYTES);
+
+        ex->timer.expires_after(REQUEST_TIMEOUT);
+        ex->timer.async_wait(
+            [ex](asio::error_code ec)
+            {
+                    if (!ec)
+                    {
+                            asio::error_code ignored;
+                            ex->socket.close(ignored);
+                    }
+            });
+
+        asio::async_read_until(
+            ex->socket,
+            ex->request,
+            "\r\n\r\n",
+            [this, ex](asio::error_code ec, std::size_t)
+            {
+                    if (ec)
+                    {
+                            ex->timer.cancel();
+                            return;
+                    }
+
+                    std::string line;
+                    std::istream stream(&ex->request);
+                    std::getline(stream, line);
+
+                    if (line.rfind("GET /metrics ", 0) == 0 || line.rfind("GET /metrics?", 0) == 0)
+                            ex->response = http_response("200 OK", "text/plain; version=0.0.4", registry_.render());
+                    else
+                            ex->response = http_response("404 Not Found", "text/plain", "Not found\n");
+
+                    asio::async_write(ex->socket,
+                                      asio::buffer(ex->response),
+                                      [ex](asio::error_code, std::size_t)
+                                      {
+                                              asio::error_code ignored;
+                                              ex->socket.shutdown(asio::ip::tcp::socket::shutdown_both, ignored);
+                                              ex->socket.close(ignored);
+                                              ex->timer.cancel();
+                                      });
+            });
+}
@@ -0,0 +1,53 @@
+/**
+ * @file metrics_server.h
+ * @brief Minimal HTTP endpoint serving a MetricsRegistry to Prometheus scrapers
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include "metrics.h"
+#include <asio.hpp>
+#include <chrono>
+
+/**
+ * @class MetricsServer
+ * @brief Answers GET /metrics on a loopback port with the registry's text exposition
+ *
+ * Runs on the caller's io_context. Each scrape reads the request head, renders
+ * the registry (atomic loads only) and writes the response asynchronously, so
+ * a slow or stalled scraper never holds up the tick timer. One request per
+ * connection; idle connections are closed after REQUEST_TIMEOUT.
+ */
+class MetricsServer
+{
+public:
+        /**
+         * @brief Construct metrics server bound to 127.0.0.1
+         * @param io ASIO I/O context
+         * @param port Port to listen on
+         * @param registry Metrics to serve (must outlive the server)
+         */
+        MetricsServer(asio::io_context& io, uint16_t port, const MetricsRegistry& registry);
+
+        /**
+         * @brief Start accepting scrape requests
+         */
+        void start();
+
+        /**
+         * @brief Get the bound port
+         * @return Local port
+         */
+        uint16_t port() const { return acceptor_.local_endpoint().port(); }
+
+private:
+        void accept();
+        void handle(asio::ip::tcp::socket socket);
+
+        asio::ip::tcp::acceptor acceptor_;
+        const MetricsRegistry& registry_;
+
+        static constexpr size_t MAX_REQUEST_BYTES = 8192;
+        static constexpr std::chrono::seconds REQUEST_TIMEOUT{5};
+};
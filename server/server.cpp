@@ -1,6 +1,25 @@
 #include "server.h"
+#include "trace.h"
+#include "log.h"
+#include <cmath>
+#include <csignal>
 #include <iostream>
 
+namespace
+{
+        uint64_t steady_now_us()
+        {
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                                 std::chrono::steady_clock::now().time_since_epoch())
+                                                 .count());
+        }
+
+        uint64_t elapsed_us(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+        {
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+        }
+}  // namespace
+
 Connection::Connection(tcp::socket socket, uint32_t id, GameServer* server)
     : socket_(std::move(socket)), player_id_(id), server_(server), latency_timer_(socket_.get_executor())
 {
@@ -8,7 +27,7 @@ Connection::Connection(tcp::socket socket, uint32_t id, GameServer* server)
 
 void Connection::start()
 {
-        std::cout << "Connection " << player_id_ << " started\n";
+        LOG_INFO("Connection {} started", player_id_);
         read_header();
 }
 
@@ -24,19 +43,20 @@ void Connection::read_header()
                                          protocol::MessageHeader header;
                                          std::memcpy(&header, self->header_buffer_.data(), sizeof(header));
 
-                                         if (header.length > sizeof(protocol::MessageHeader) && header.length < 65536)
+                                         // Header-only messages (CLIENT_CONNECT) go through read_body with an empty body
+                                         if (header.length >= sizeof(protocol::MessageHeader) && header.length < 65536)
                                          {
                                                  self->read_body(header.length - sizeof(protocol::MessageHeader));
                                          }
                                          else
                                          {
+                                                 self->server_->metrics().malformed_messages.inc();
                                                  self->read_header();
                                          }
                                  }
                                  else
                                  {
-                                         std::cout << "Connection " << self->player_id_ << " error: " << ec.message()
-                                                   << "\n";
+                                         LOG_WARN("Connection {} error: {}", self->player_id_, ec.message());
                                          self->server_->player_disconnected(self->player_id_);
                                  }
                          });
@@ -54,6 +74,11 @@ void Connection::read_body(uint32_t length)
             {
                     if (!ec)
                     {
+                            ServerMetrics& metrics = self->server_->metrics();
+                            size_t slot            = ServerMetrics::slot(self->header_buffer_[0]);
+                            metrics.bytes_received[slot]->inc(self->header_buffer_.size() + self->body_buffer_.size());
+                            metrics.messages_received[slot]->inc();
+
                             std::vector<uint8_t> full_msg;
                             full_msg.insert(full_msg.end(), self->header_buffer_.begin(), self->header_buffer_.end());
                             full_msg.insert(full_msg.end(), self->body_buffer_.begin(), self->body_buffer_.end());
@@ -72,7 +97,7 @@ void Connection::read_body(uint32_t length)
                     }
                     else
                     {
-                            std::cout << "Connection " << self->player_id_ << " body error\n";
+                            LOG_WARN("Connection {} body error: {}", self->player_id_, ec.message());
                             self->server_->player_disconnected(self->player_id_);
                     }
             });
@@ -89,7 +114,7 @@ void Connection::process_message(const std::vector<uint8_t>& data)
         switch (header.type)
         {
         case protocol::MessageType::CLIENT_CONNECT:
-                std::cout << "Player " << player_id_ << " connected\n";
+                LOG_INFO("Player {} connected", player_id_);
 
                 // Send assigned player id back to client so it knows which entity
                 // is its own. Use SERVER_START_GAME message with the id.
@@ -106,8 +131,54 @@ void Connection::process_message(const std::vector<uint8_t>& data)
         {
                 protocol::ClientInput input;
                 if (reader.read_float(input.dx) && reader.read_float(input.dy) && reader.read_uint32(input.timestamp) &&
-                    reader.read_uint32(input.seq))
+                    reader.read_uint32(input.seq) && reader.read_uint32(input.ack_tick))
                 {
+                        if (inputs_in_flight_.size() >= MAX_INPUTS_IN_FLIGHT)
+                                inputs_in_flight_.pop_front();
+                        inputs_in_flight_.push_back(InputArrival{input.seq, std::chrono::steady_clock::now()});
+                        server_->process_input(player_id_, input);
+                }
+                break;
+        }
+
+        case protocol::MessageType::CLIENT_TIME_REQUEST:
+        {
+                // Answer immediately with steady-clock times (the clock snapshots are stamped with)
+                protocol::TimeSyncMessage sync;
+                if (!reader.read_uint64(sync.client_send_us))
+                        break;
+                sync.server_receive_us = steady_now_us();
+
+                protocol::MessageBuffer reply;
+                reply.write_header(protocol::MessageType::SERVER_TIME_RESPONSE);
+                reply.write_uint64(sync.client_send_us);
+                reply.write_uint64(sync.server_receive_us);
+                sync.server_send_us = steady_now_us();
+                reply.write_uint64(sync.server_send_us);
+                reply.finalize();
+                send_message(reply);
+                break;
+        }
+
+        case protocol::MessageType::CLIENT_INPUT_BATCH:
+        {
+                protocol::InputBatchMessage batch;
+                if (!reader.read_uint32(batch.first_seq) || !reader.read_uint32(batch.ack_tick) ||
+                    !reader.read_uint8(batch.count))
+                        break;
+
+                // Each command is one input tick; queue them in order exactly like single inputs
+                auto now = std::chrono::steady_clock::now();
+                for (uint32_t i = 0; i < batch.count; ++i)
+                {
+                        protocol::InputCommand cmd;
+                        if (!reader.read_input_command(cmd))
+                                break;
+
+                        protocol::ClientInput input{cmd.dx, cmd.dy, cmd.timestamp, batch.first_seq + i, batch.ack_tick};
+                        if (inputs_in_flight_.size() >= MAX_INPUTS_IN_FLIGHT)
+                                inputs_in_flight_.pop_front();
+                        inputs_in_flight_.push_back(InputArrival{input.seq, now});
                         server_->process_input(player_id_, input);
                 }
                 break;
@@ -123,42 +194,227 @@ void Connection::send_message(const protocol::MessageBuffer& msg)
         delayed_send(msg);
 }
 
+void Connection::inputs_applied(uint32_t seq, std::chrono::steady_clock::time_point now)
+{
+        while (!inputs_in_flight_.empty() && inputs_in_flight_.front().seq <= seq)
+        {
+                input_latency_us_.record(elapsed_us(inputs_in_flight_.front().at, now));
+                inputs_in_flight_.pop_front();
+        }
+}
+
+std::string Connection::latency_summary() const
+{
+        return "  input latency: " + input_latency_us_.summary() + "\n  send dwell:    " + send_dwell_us_.summary() +
+               "\n";
+}
+
+void Connection::log_latency() const
+{
+        LOG_INFO("Connection {} input latency: p50 {} us, p99 {} us, max {} us, n={}",
+                 player_id_,
+                 input_latency_us_.value_at_percentile(50.0),
+                 input_latency_us_.value_at_percentile(99.0),
+                 input_latency_us_.max(),
+                 input_latency_us_.count());
+        LOG_INFO("Connection {} send dwell: p50 {} us, p99 {} us, max {} us, n={}",
+                 player_id_,
+                 send_dwell_us_.value_at_percentile(50.0),
+                 send_dwell_us_.value_at_percentile(99.0),
+                 send_dwell_us_.max(),
+                 send_dwell_us_.count());
+}
+
 void Connection::delayed_send(const protocol::MessageBuffer& msg)
 {
-        auto self = shared_from_this();
+        auto self      = shared_from_this();
+        auto type      = static_cast<protocol::MessageType>(msg.data.empty() ? 0 : msg.data[0]);
+        auto queued_at = std::chrono::steady_clock::now();
+        server_->metrics().sends_in_flight.add(1.0);
         // Simulate 200ms send latency using a per-message timer so broadcasts
         // and individual messages do not overwrite each other's timers.
         auto timer = std::make_shared<asio::steady_timer>(self->socket_.get_executor());
         timer->expires_after(std::chrono::milliseconds(200));
         timer->async_wait(
-            [self, data = msg.data, timer](auto ec)
+            [self, data = msg.data, timer, type, queued_at](auto ec)
             {
                     if (!ec)
                     {
+                            TRACE_SCOPE("send.write");
                             asio::async_write(self->socket_,
                                               asio::buffer(data),
-                                              [self](asio::error_code ec, std::size_t)
+                                              [self, type, queued_at](asio::error_code ec, std::size_t bytes)
                                               {
+                                                      ServerMetrics& metrics = self->server_->metrics();
+                                                      metrics.sends_in_flight.add(-1.0);
                                                       if (ec)
                                                       {
-                                                              std::cout << "Send error to " << self->player_id_ << "\n";
+                                                              LOG_WARN("Send error to {}: {}", self->player_id_, ec.message());
+                                                              metrics.send_errors.inc();
+                                                              return;
                                                       }
+
+                                                      size_t slot = ServerMetrics::slot(static_cast<uint8_t>(type));
+                                                      metrics.bytes_sent[slot]->inc(bytes);
+                                                      metrics.messages_sent[slot]->inc();
+
+                                                      uint64_t dwell =
+                                                          elapsed_us(queued_at, std::chrono::steady_clock::now());
+                                                      self->send_dwell_us_.record(dwell);
+                                                      self->server_->record_send_dwell(type, dwell);
                                               });
                     }
+                    else
+                    {
+                            self->server_->metrics().sends_in_flight.add(-1.0);
+                    }
             });
 }
 
-GameServer::GameServer(asio::io_context& io, uint16_t port)
-    : io_(io), acceptor_(io, tcp::endpoint(tcp::v4(), port)), broadcast_timer_(io), next_player_id_(1)
+ServerMetrics::ServerMetrics(MetricsRegistry& registry)
+    : connections(registry.gauge("game_connections", "Open client connections")),
+      rooms(registry.gauge("game_rooms", "Active game sessions")),
+      ticks(registry.counter("game_ticks_total", "Simulation ticks run")),
+      ticks_skipped(registry.counter("game_ticks_skipped_total", "Tick deadlines dropped under overload")),
+      late_wakeups(registry.counter("game_tick_late_wakeups_total", "Tick timer wake-ups a full period late")),
+      wakeup_jitter_mean(registry.gauge("game_tick_wakeup_jitter_seconds", "Tick timer wake-up lateness since start",
+                                        "stat=\"mean\"")),
+      wakeup_jitter_max(registry.gauge("game_tick_wakeup_jitter_seconds", "", "stat=\"max\"")),
+      ticks_per_second(registry.gauge("game_ticks_per_second", "Ticks run over the last publish interval")),
+      tick_p50_seconds(registry.gauge("game_tick_duration_seconds", "Tick duration over the last publish interval",
+                                      "quantile=\"0.5\"")),
+      tick_p99_seconds(registry.gauge("game_tick_duration_seconds", "", "quantile=\"0.99\"")),
+      tick_max_seconds(registry.gauge("game_tick_duration_seconds", "", "quantile=\"1\"")),
+      input_queue_depth(registry.gauge("game_input_queue_depth", "Inputs waiting for the next tick")),
+      sends_in_flight(registry.gauge("game_sends_in_flight", "Outgoing messages not yet written")),
+      inputs_dropped(registry.counter("game_inputs_dropped_total", "Inputs dropped because the queue was full")),
+      malformed_messages(registry.counter("game_malformed_messages_total", "Messages with an invalid header")),
+      send_errors(registry.counter("game_send_errors_total", "Failed socket writes"))
 {
-        session_ = std::make_shared<GameSession>(io);
+        static const char* const names[TYPE_SLOTS] = {
+            "unknown",
+            "client_connect",
+            "client_input",
+            "server_game_state",
+            "server_start_game",
+            "client_disconnect",
+            "client_input_batch",
+            "client_time_request",
+            "server_time_response"};
+
+        for (size_t i = 0; i < TYPE_SLOTS; ++i)
+        {
+                std::string label    = std::string("type=\"") + names[i] + "\"";
+                bytes_received[i]    = &registry.counter("game_bytes_received_total", "Bytes received", label);
+                bytes_sent[i]        = &registry.counter("game_bytes_sent_total", "Bytes sent", label);
+                messages_received[i] = &registry.counter("game_messages_received_total", "Messages received", label);
+                messages_sent[i]     = &registry.counter("game_messages_sent_total", "Messages sent", label);
+        }
+}
+
+GameServer::GameServer(asio::io_context& io, uint16_t port, uint32_t seed)
+    : io_(io),
+      acceptor_(io, tcp::endpoint(tcp::v4(), port)),
+      scheduler_(io,
+                 std::chrono::nanoseconds(1000000000 / GameSession::TICK_RATE),
+                 [this](uint64_t tick) { on_tick(tick); }),
+      next_player_id_(1),
+      report_signals_(io),
+      trace_signals_(io),
+      metrics_(metrics_registry_),
+      window_ticks_(0),
+      published_skipped_(0),
+      published_late_(0)
+{
+        session_ = std::make_shared<GameSession>(std::make_shared<SteadyClock>(), seed);
+        metrics_.rooms.set(1.0);
+        std::cout << "Session seed: " << seed << "\n";
+}
+
+void GameServer::trace_to(const std::string& path)
+{
+        trace_path_ = path;
+#if !defined(ENABLE_TRACING)
+        std::cout << "Warning: built without ENABLE_TRACING, " << path << " will not be written\n";
+#endif
+}
+
+void GameServer::serve_metrics(uint16_t port)
+{
+        metrics_server_ = std::make_unique<MetricsServer>(io_, port, metrics_registry_);
+        std::cout << "Serving metrics on http://127.0.0.1:" << metrics_server_->port() << "/metrics\n";
+}
+
+void GameServer::set_snapshot_rate(uint32_t hz)
+{
+        broadcast_interval_ticks_ = GameSession::broadcast_interval_ticks(hz);
+        std::cout << "Broadcasting snapshots every " << broadcast_interval_ticks_ << " ticks ("
+                  << GameSession::TICK_RATE / static_cast<double>(broadcast_interval_ticks_) << " Hz)\n";
+}
+
+void GameServer::record_match(const std::string& path)
+{
+        session_->set_match_log(std::make_shared<MatchLog>(path, session_->seed()));
+        std::cout << "Recording match to " << path << "\n";
 }
 
 void GameServer::start()
 {
         std::cout << "Server started on port " << acceptor_.local_endpoint().port() << "\n";
         accept_connection();
-        broadcast_state();
+        scheduler_.start();
+        window_start_ = std::chrono::steady_clock::now();
+        if (metrics_server_)
+                metrics_server_->start();
+
+#if defined(SIGUSR1)
+        report_signals_.add(SIGUSR1);
+        wait_for_report_signal();
+#endif
+
+        if (!trace_path_.empty())
+        {
+                trace::set_thread_name("io");
+                trace_signals_.add(SIGINT);
+                trace_signals_.add(SIGTERM);
+#if defined(SIGUSR2)
+                trace_signals_.add(SIGUSR2);
+#endif
+                wait_for_trace_signal();
+        }
+}
+
+void GameServer::wait_for_trace_signal()
+{
+        trace_signals_.async_wait(
+            [this](asio::error_code ec, int signal)
+            {
+                    if (ec)
+                            return;
+
+                    if (trace::write_json(trace_path_))
+                            std::cout << "Wrote trace to " << trace_path_ << "\n";
+
+                    if (signal == SIGINT || signal == SIGTERM)
+                    {
+                            io_.stop();
+                            return;
+                    }
+                    wait_for_trace_signal();
+            });
+}
+
+void GameServer::wait_for_report_signal()
+{
+        report_signals_.async_wait(
+            [this](asio::error_code ec, int)
+            {
+                    if (ec)
+                            return;
+
+                    print_latency_report();
+                    wait_for_report_signal();
+            });
 }
 
 void GameServer::accept_connection()
@@ -171,6 +427,7 @@ void GameServer::accept_connection()
                             uint32_t id      = next_player_id_++;
                             auto conn        = std::make_shared<Connection>(std::move(socket), id, this);
                             connections_[id] = conn;
+                            metrics_.connections.set(static_cast<double>(connections_.size()));
                             session_->add_player(id);
                             conn->start();
 
@@ -184,31 +441,116 @@ void GameServer::accept_connection()
             });
 }
 
+void GameServer::on_tick(uint64_t tick)
+{
+        TRACE_SCOPE("server.on_tick");
+        metrics_.input_queue_depth.set(static_cast<double>(session_->pending_inputs()));
+
+        auto tick_start = std::chrono::steady_clock::now();
+        session_->tick();
+        auto tick_end    = std::chrono::steady_clock::now();
+        uint64_t tick_us = elapsed_us(tick_start, tick_end);
+        tick_duration_us_.record(tick_us);
+        tick_window_us_.record(tick_us);
+        metrics_.ticks.inc();
+        window_ticks_++;
+
+        for (auto& [id, conn] : connections_)
+        {
+                conn->inputs_applied(session_->last_input_seq(id), tick_end);
+        }
+
+        // Broadcast right after a tick completes so every snapshot reflects a whole number of ticks
+        if (tick % broadcast_interval_ticks_ == 0)
+        {
+                broadcast_state();
+                broadcast_duration_us_.record(elapsed_us(tick_end, std::chrono::steady_clock::now()));
+        }
+
+        if (tick_end - window_start_ >= METRICS_PUBLISH_INTERVAL)
+        {
+                publish_tick_metrics(tick_end);
+        }
+}
+
+void GameServer::publish_tick_metrics(std::chrono::steady_clock::time_point now)
+{
+        // Percentiles are computed here, once per interval, so a scrape only reads atomics
+        double seconds = std::chrono::duration<double>(now - window_start_).count();
+        metrics_.ticks_per_second.set(static_cast<double>(window_ticks_) / seconds);
+        metrics_.tick_p50_seconds.set(static_cast<double>(tick_window_us_.value_at_percentile(50.0)) * 1e-6);
+        metrics_.tick_p99_seconds.set(static_cast<double>(tick_window_us_.value_at_percentile(99.0)) * 1e-6);
+        metrics_.tick_max_seconds.set(static_cast<double>(tick_window_us_.max()) * 1e-6);
+
+        const TickScheduler::Stats& stats = scheduler_.stats();
+        metrics_.ticks_skipped.inc(stats.ticks_skipped - published_skipped_);
+        published_skipped_ = stats.ticks_skipped;
+        metrics_.late_wakeups.inc(stats.late_wakeups - published_late_);
+        published_late_ = stats.late_wakeups;
+        metrics_.wakeup_jitter_mean.set(stats.mean_jitter_us() * 1e-6);
+        metrics_.wakeup_jitter_max.set(static_cast<double>(stats.max_jitter_us) * 1e-6);
+
+        tick_window_us_.reset();
+        window_ticks_ = 0;
+        window_start_ = now;
+}
+
 void GameServer::broadcast_state()
 {
         auto state_msg = session_->create_state_message();
 
+        TRACE_SCOPE("snapshot.fan_out");
         for (auto& [id, conn] : connections_)
         {
                 conn->send_message(state_msg);
         }
-
-        broadcast_timer_.expires_after(std::chrono::milliseconds(50));
-        broadcast_timer_.async_wait(
-            [this](auto ec)
-            {
-                    if (!ec)
-                            broadcast_state();
-            });
 }
 
 void GameServer::process_input(uint32_t player_id, const protocol::ClientInput& input)
 {
-        session_->process_input(player_id, input);
+        // Hand the input to the simulation; it is applied on the session's next tick
+        if (!session_->push_input(player_id, input))
+        {
+                LOG_WARN("Input queue full, dropped input from player {}", player_id);
+                metrics_.inputs_dropped.inc();
+        }
+}
+
+void GameServer::record_send_dwell(protocol::MessageType type, uint64_t dwell_us)
+{
+        send_dwell_by_type_us_[type].record(dwell_us);
+}
+
+void GameServer::print_latency_report() const
+{
+        const TickScheduler::Stats& stats = scheduler_.stats();
+        std::cout << "Latency report (" << connections_.size() << " connections)\n"
+                  << "  tick:      " << tick_duration_us_.summary() << "\n"
+                  << "  wake-up:   mean " << std::llround(stats.mean_jitter_us()) << " us, max " << stats.max_jitter_us << " us, "
+                  << stats.late_wakeups << " late of " << stats.wakeups << ", " << stats.ticks_skipped
+                  << " ticks skipped\n"
+                  << "  broadcast: " << broadcast_duration_us_.summary() << "\n";
+
+        for (const auto& [type, hist] : send_dwell_by_type_us_)
+        {
+                std::cout << "  send dwell, message type " << static_cast<int>(type) << ": " << hist.summary() << "\n";
+        }
+
+        for (const auto& [id, conn] : connections_)
+        {
+                std::cout << "Connection " << id << "\n" << conn->latency_summary();
+        }
 }
 
 void GameServer::player_disconnected(uint32_t player_id)
 {
+        auto it = connections_.find(player_id);
+        if (it != connections_.end())
+        {
+                it->second->log_latency();
+        }
+
         connections_.erase(player_id);
+        metrics_.connections.set(static_cast<double>(connections_.size()));
         session_->remove_player(player_id);
 }
\ No newline at end of file
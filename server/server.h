@@ -8,7 +8,15 @@
 #pragma once
 #include "protocol.h"
 #include "session.h"
+#include "tick_scheduler.h"
+#include "histogram.h"
+#include "metrics.h"
+#include "metrics_server.h"
+#include <array>
 #include <asio.hpp>
+#include <chrono>
+#include <deque>
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <queue>
@@ -18,6 +26,10 @@ using asio::ip::tcp;
 /**
  * @class Connection
  * @brief Manages a single client connection with message handling and latency simulation
+ *
+ * Each connection keeps two latency histograms (microseconds): input latency, from
+ * an input reaching the server to the tick that applied it, and send dwell, from
+ * send_message() to the completed socket write (simulated latency included).
  */
 class Connection : public std::enable_shared_from_this<Connection>
 {
@@ -47,6 +59,25 @@ public:
          */
         uint32_t get_id() const { return player_id_; }
 
+        /**
+         * @brief Record input latency for every queued input up to the one the simulation just applied
+         * @param seq Newest input seq applied for this player
+         * @param now Time the applying tick finished
+         */
+        void inputs_applied(uint32_t seq, std::chrono::steady_clock::time_point now);
+
+        /**
+         * @brief Format this connection's latency percentiles
+         * @return One line per histogram
+         */
+        std::string latency_summary() const;
+
+        /**
+         * @brief Log this connection's latency percentiles through the async logger
+         * @note Only numbers are captured, so nothing is formatted on the calling thread
+         */
+        void log_latency() const;
+
 private:
         void read_header();
         void read_body(uint32_t length);
@@ -62,6 +93,61 @@ private:
 
         asio::steady_timer latency_timer_;
         std::queue<std::vector<uint8_t>> send_queue_;  ///< Queue of pending messages
+
+        /**
+         * @struct InputArrival
+         * @brief Input received but not yet applied by a tick
+         */
+        struct InputArrival
+        {
+                uint32_t seq;
+                std::chrono::steady_clock::time_point at;
+        };
+
+        std::deque<InputArrival> inputs_in_flight_;  ///< Oldest first; trimmed by inputs_applied()
+        Histogram input_latency_us_;                 ///< Input arrival -> applied by a tick
+        Histogram send_dwell_us_;                    ///< send_message() -> write completed
+
+        static constexpr size_t MAX_INPUTS_IN_FLIGHT = 1024;  ///< Bound on tracked inputs (misbehaving clients)
+};
+
+/**
+ * @struct ServerMetrics
+ * @brief Handles to every metric the server publishes, registered once at startup
+ */
+struct ServerMetrics
+{
+        explicit ServerMetrics(MetricsRegistry& registry);
+
+        static constexpr size_t TYPE_SLOTS = 9;  ///< Message types 1..8; slot 0 counts unknown types
+
+        /**
+         * @brief Map a wire message type to its per-type counter slot
+         * @param type Message type byte
+         * @return Slot index in [0, TYPE_SLOTS)
+         */
+        static size_t slot(uint8_t type) { return type < TYPE_SLOTS ? type : 0; }
+
+        Gauge& connections;
+        Gauge& rooms;
+        Counter& ticks;
+        Counter& ticks_skipped;
+        Counter& late_wakeups;       ///< Tick timer wake-ups at least one full period late
+        Gauge& wakeup_jitter_mean;   ///< Mean tick timer lateness since start (seconds)
+        Gauge& wakeup_jitter_max;    ///< Worst tick timer lateness since start (seconds)
+        Gauge& ticks_per_second;
+        Gauge& tick_p50_seconds;
+        Gauge& tick_p99_seconds;
+        Gauge& tick_max_seconds;
+        Gauge& input_queue_depth;  ///< Ingestion queue depth just before each tick drains it
+        Gauge& sends_in_flight;    ///< Messages queued for sending, across all connections
+        Counter& inputs_dropped;
+        Counter& malformed_messages;
+        Counter& send_errors;
+        std::array<Counter*, TYPE_SLOTS> bytes_received;
+        std::array<Counter*, TYPE_SLOTS> bytes_sent;
+        std::array<Counter*, TYPE_SLOTS> messages_received;
+        std::array<Counter*, TYPE_SLOTS> messages_sent;
 };
 
 /**
@@ -75,16 +161,52 @@ public:
          * @brief Construct game server
          * @param io ASIO I/O context
          * @param port Port to listen on
+         * @param seed Seed for the game session RNG
          */
-        GameServer(asio::io_context& io, uint16_t port);
+        GameServer(asio::io_context& io, uint16_t port, uint32_t seed);
 
         /**
-         * @brief Start accepting connections and broadcasting game state
+         * @brief Record the match to a file for later replay
+         * @param path Output file path
+         * @note Call before start()
+         */
+        void record_match(const std::string& path);
+
+        /**
+         * @brief Write a Chrome trace of tick phases on SIGUSR2 and on SIGINT/SIGTERM (which then stop the server)
+         * @param path Output JSON path
+         * @note Call before start(); needs a build with ENABLE_TRACING
+         */
+        void trace_to(const std::string& path);
+
+        /**
+         * @brief Serve Prometheus metrics on http://127.0.0.1:port/metrics
+         * @param port Metrics port
+         * @note Call before start()
+         */
+        void serve_metrics(uint16_t port);
+
+        /**
+         * @brief Set how often game state is broadcast
+         * @param hz Snapshots per second, rounded to a whole number of ticks (1..TICK_RATE)
+         * @note Call before start(). Clients interpolate with snapshot velocities, so rates below the
+         *       default 20 Hz stay smooth and cut download bandwidth proportionally.
+         */
+        void set_snapshot_rate(uint32_t hz);
+
+        /**
+         * @brief Get the server's metric handles
+         * @return Metrics (updated from the I/O thread, read by scrapes)
+         */
+        ServerMetrics& metrics() { return metrics_; }
+
+        /**
+         * @brief Start accepting connections, ticking the simulation and broadcasting game state
          */
         void start();
 
         /**
-         * @brief Process input from a client
+         * @brief Queue input from a client for the game session
          * @param player_id Player ID
          * @param input Client input data
          */
@@ -96,15 +218,50 @@ public:
          */
         void player_disconnected(uint32_t player_id);
 
+        /**
+         * @brief Record how long a message spent between send_message() and write completion
+         * @param type Message type
+         * @param dwell_us Dwell time in microseconds
+         */
+        void record_send_dwell(protocol::MessageType type, uint64_t dwell_us);
+
+        /**
+         * @brief Print tick, broadcast, per-message-type and per-connection latency percentiles
+         */
+        void print_latency_report() const;
+
 private:
         void accept_connection();
+        void on_tick(uint64_t tick);
         void broadcast_state();
+        void wait_for_report_signal();
+        void wait_for_trace_signal();
+        void publish_tick_metrics(std::chrono::steady_clock::time_point now);
 
         asio::io_context& io_;
         tcp::acceptor acceptor_;
-        asio::steady_timer broadcast_timer_;
+        TickScheduler scheduler_;  ///< Drives simulation ticks and tick-aligned broadcasts
 
         uint32_t next_player_id_;
         std::shared_ptr<GameSession> session_;
         std::unordered_map<uint32_t, std::shared_ptr<Connection>> connections_;
+
+        asio::signal_set report_signals_;  ///< SIGUSR1 dumps latency percentiles (where available)
+        asio::signal_set trace_signals_;   ///< Trace dump triggers, armed by trace_to()
+        std::string trace_path_;
+        Histogram tick_duration_us_;       ///< Wall time of session_->tick() (one room per server)
+        Histogram broadcast_duration_us_;  ///< Wall time to serialize and fan out one snapshot
+        std::map<protocol::MessageType, Histogram> send_dwell_by_type_us_;  ///< Send dwell per message type
+
+        MetricsRegistry metrics_registry_;
+        ServerMetrics metrics_;
+        std::unique_ptr<MetricsServer> metrics_server_;  ///< Only created by serve_metrics()
+        Histogram tick_window_us_;                       ///< Tick durations since the last publish
+        std::chrono::steady_clock::time_point window_start_;
+        uint64_t window_ticks_;
+        uint64_t published_skipped_;  ///< Scheduler skipped-tick count at the last publish
+        uint64_t published_late_;     ///< Scheduler late wake-up count at the last publish
+
+        uint64_t broadcast_interval_ticks_ = 3;  ///< Snapshot every 3 ticks (50ms at 60Hz) unless set_snapshot_rate()
+        static constexpr std::chrono::seconds METRICS_PUBLISH_INTERVAL{1};  ///< Tick rate/percentile gauge refresh
 };
\ No newline at end of file
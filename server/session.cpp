@@ -1,91 +1,160 @@
 #include "session.h"
-#include <iostream>
+#include "sim_kernels.h"
+#include "trace.h"
+#include "log.h"
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 
-GameSession::GameSession(asio::io_context& io)
-    : io_(io), update_timer_(io), coin_spawn_timer_(io), next_coin_id_(1), game_running_(false)
+namespace
+{
+        // FNV-1a, fed field by field so padding never reaches the hash
+        struct Fnv1a
+        {
+                uint64_t value = 14695981039346656037ull;
+
+                void bytes(const void* data, size_t size)
+                {
+                        const uint8_t* p = static_cast<const uint8_t*>(data);
+                        for (size_t i = 0; i < size; ++i)
+                        {
+                                value ^= p[i];
+                                value *= 1099511628211ull;
+                        }
+                }
+
+                void u32(uint32_t v) { bytes(&v, sizeof(v)); }
+                void u64(uint64_t v) { bytes(&v, sizeof(v)); }
+
+                void f32(float v)
+                {
+                        uint32_t bits;
+                        std::memcpy(&bits, &v, sizeof(bits));
+                        u32(bits);
+                }
+        };
+}  // namespace
+
+GameSession::GameSession() : GameSession(std::make_shared<SteadyClock>(), std::random_device{}()) {}
+
+GameSession::GameSession(std::shared_ptr<const Clock> clock, uint32_t seed)
+    : coin_grid_(MAP_WIDTH, MAP_HEIGHT, GRID_CELL),
+      player_grid_(MAP_WIDTH, MAP_HEIGHT, GRID_CELL),
+      input_queue_(INPUT_QUEUE_CAPACITY),
+      clock_(std::move(clock)),
+      seed_(seed),
+      next_coin_id_(1),
+      rng_(seed),
+      tick_(0),
+      game_running_(false)
 {
-        std::random_device rd;
-        rng_.seed(rd());
 }
 
 void GameSession::add_player(uint32_t player_id)
 {
-        protocol::PlayerState ps;
-        ps.id                       = player_id;
-        ps.position                 = protocol::Vec2(400.0f, 300.0f);
-        ps.score                    = 0;
-        ps.last_processed_input_seq = 0;
-        ps.last_processed_input_ts  = 0;
-        players_[player_id]         = ps;
-        std::cout << "Player " << player_id << " joined. Total: " << players_.size() << "\n";
+        if (players_.find(player_id) != EntityIndex::NPOS)
+                return;
+
+        protocol::Vec2 spawn(400.0f, 300.0f);
+        players_.add(player_id, spawn);
+        player_grid_.insert(player_id, spawn);
+        if (match_log_)
+                match_log_->join(static_cast<uint32_t>(tick_), player_id);
+        LOG_INFO("Player {} joined. Total: {}", player_id, players_.size());
 }
 
 void GameSession::remove_player(uint32_t player_id)
 {
-        players_.erase(player_id);
-        std::cout << "Player " << player_id << " left. Total: " << players_.size() << "\n";
+        uint32_t i = players_.find(player_id);
+        if (i != EntityIndex::NPOS)
+        {
+                player_grid_.remove(player_id, players_.position(i));
+                players_.remove(player_id);
+                if (match_log_)
+                        match_log_->leave(static_cast<uint32_t>(tick_), player_id);
+        }
+
+        LOG_INFO("Player {} left. Total: {}", player_id, players_.size());
 }
 
-void GameSession::process_input(uint32_t player_id, const protocol::ClientInput& input)
+bool GameSession::push_input(uint32_t player_id, const protocol::ClientInput& input)
 {
-        auto it = players_.find(player_id);
-        if (it == players_.end() || !game_running_)
-                return;
-
-        auto now = std::chrono::steady_clock::now();
-        float dt = std::chrono::duration<float>(now - last_update_).count();
-        // Clamp dt to a sensible maximum to avoid huge jumps after pauses.
-        // If dt is very large (e.g., server was paused), cap to 100ms.
-        if (dt > 0.1f)
-                dt = 0.1f;
+        return input_queue_.try_push(QueuedInput{player_id, input});
+}
 
-        protocol::PlayerState& player = it->second;
+uint32_t GameSession::last_input_seq(uint32_t player_id) const
+{
+        uint32_t i = players_.find(player_id);
+        return i == EntityIndex::NPOS ? 0 : players_.last_input_seq[i];
+}
 
-        // Normalize input
-        float len = std::sqrt(input.dx * input.dx + input.dy * input.dy);
-        if (len > 0.01f)
+void GameSession::drain_inputs()
+{
+        TRACE_SCOPE("tick.drain_inputs");
+        QueuedInput queued;
+        while (input_queue_.try_pop(queued))
         {
-                float nx           = input.dx / len;
-                float ny           = input.dy / len;
+                uint32_t i = players_.find(queued.player_id);
+                if (i == EntityIndex::NPOS)
+                        continue;
 
-                player.position.x += nx * PLAYER_SPEED * dt;
-                player.position.y += ny * PLAYER_SPEED * dt;
-
-                // Clamp to map bounds
-                player.position.x = std::max(PLAYER_RADIUS, std::min(MAP_WIDTH - PLAYER_RADIUS, player.position.x));
-                player.position.y = std::max(PLAYER_RADIUS, std::min(MAP_HEIGHT - PLAYER_RADIUS, player.position.y));
+                players_.inputs[i].push(queued.input);
+                if (match_log_)
+                        match_log_->input(queued.player_id, queued.input);
         }
+}
+
+bool GameSession::collect_coins(uint32_t index, const protocol::ClientInput& input)
+{
+        // Broad phase picks the neighbouring cells, the SIMD kernel tests each cell's coins
+        collected_.clear();
+        coin_grid_.collect_within(players_.position(index), PICKUP_DIST, collected_);
+        if (collected_.empty())
+                return false;
 
-        // Check coin collisions
-        std::vector<uint32_t> collected;
-        for (auto& [coin_id, coin] : coins_)
+        // Coins never move, so the live overlap is what the client saw, provided the coin was in its snapshot.
+        // Clients that have not seen a snapshot yet, or claim one from the future, are judged on the live state.
+        const bool judge_live = input.ack_tick == 0 || input.ack_tick > tick_;
+        bool deferred         = false;
+
+        for (uint32_t coin_id : collected_)
         {
-                if (check_coin_collision(player_id, coin_id))
+                uint32_t c = coins_.find(coin_id);
+                if (c == EntityIndex::NPOS)
+                        continue;
+
+                // Spawned after the snapshot the client acted on: retried once its ack catches up
+                if (!judge_live && coins_.spawn_tick[c] > input.ack_tick)
                 {
-                        collected.push_back(coin_id);
-                        player.score++;
+                        deferred = true;
+                        continue;
                 }
-        }
 
-        for (uint32_t coin_id : collected)
-        {
-                coins_.erase(coin_id);
-                // Calculate approximate one-way input lag (ms)
-                auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                  std::chrono::steady_clock::now().time_since_epoch())
-                                  .count();
-                uint32_t lag_ms = 0;
-                if (input.timestamp <= static_cast<uint32_t>(now_ms))
-                        lag_ms = static_cast<uint32_t>(now_ms) - input.timestamp;
-
-                std::cout << "Player " << player_id << " collected coin. Score: " << player.score
-                          << " (input lag: " << lag_ms << " ms)\n";
+                award_coin(index, coin_id, input.timestamp);
         }
+        return deferred;
+}
 
-        // Record last processed input sequence and timestamp for this player so client can reconcile and measure ping
-        players_[player_id].last_processed_input_seq = input.seq;
-        players_[player_id].last_processed_input_ts  = input.timestamp;
+void GameSession::award_coin(uint32_t index, uint32_t coin_id, uint32_t input_ts)
+{
+        uint32_t c = coins_.find(coin_id);
+        if (c == EntityIndex::NPOS)
+                return;
+
+        coin_grid_.remove(coin_id, coins_.position(c));
+        coins_.remove(coin_id);
+        players_.score[index]++;
+
+        // Calculate approximate one-way input lag (ms)
+        uint32_t now_ms = clock_->now_ms();
+        uint32_t lag_ms = 0;
+        if (input_ts <= now_ms)
+                lag_ms = now_ms - input_ts;
+
+        LOG_INFO("Player {} collected coin. Score: {} (input lag: {} ms)",
+                 players_.id[index],
+                 players_.score[index],
+                 lag_ms);
 }
 
 void GameSession::start()
@@ -93,48 +162,103 @@ void GameSession::start()
         if (game_running_)
                 return;
         game_running_ = true;
-        last_update_  = std::chrono::steady_clock::now();
+        if (match_log_)
+                match_log_->start(static_cast<uint32_t>(tick_));
 
-        std::cout << "Game starting!\n";
+        LOG_INFO("Game starting!");
 
-        // Spawn initial coins
+        // Spawn initial coins; the snapshot for the current tick may already be out, so they show from the next one
         for (int i = 0; i < 3; i++)
         {
-                spawn_coin();
+                spawn_coin(tick_ + 1);
         }
-
-        // Start game loop
-        update_timer_.expires_after(std::chrono::milliseconds(16));
-        update_timer_.async_wait(
-            [self = shared_from_this()](auto ec)
-            {
-                    if (!ec)
-                            self->update_game_logic();
-            });
-
-        // Start coin spawner (infinite loop)
-        schedule_coin_spawn();
 }
 
-void GameSession::update_game_logic()
+void GameSession::tick()
 {
         if (!game_running_)
                 return;
 
-        last_update_ = std::chrono::steady_clock::now();
+        TRACE_SCOPE("session.tick");
+
+        // Move everything the network side queued since the previous tick into per-player queues
+        drain_inputs();
+
+        const size_t n = players_.size();
+        tick_inputs_.resize(n);
+        input_dx_.resize(n);
+        input_dy_.resize(n);
+        moved_.resize(n);
+        prev_x_.assign(players_.x.begin(), players_.x.end());
+        prev_y_.assign(players_.y.begin(), players_.y.end());
+
+        {
+                TRACE_SCOPE("tick.move");
 
-        // Continue update loop
-        update_timer_.expires_after(std::chrono::milliseconds(16));
-        update_timer_.async_wait(
-            [self = shared_from_this()](auto ec)
-            {
-                    if (!ec)
-                            self->update_game_logic();
-            });
+                // Consume exactly one input per player
+                for (uint32_t i = 0; i < n; ++i)
+                {
+                        protocol::ClientInput& input = tick_inputs_[i];
+                        bool fresh                   = players_.inputs[i].consume(input);
+                        input_dx_[i]                 = input.dx;
+                        input_dy_[i]                 = input.dy;
+
+                        // Acknowledge only inputs the client actually sent so its reconciliation replays the rest
+                        if (fresh)
+                        {
+                                players_.last_input_seq[i] = input.seq;
+                                players_.last_input_ts[i]  = input.timestamp;
+                        }
+                }
+
+                // Move every player in one pass over the contiguous position arrays
+                sim::integrate(players_.x.data(),
+                               players_.y.data(),
+                               input_dx_.data(),
+                               input_dy_.data(),
+                               moved_.data(),
+                               n,
+                               movement::PLAYER);
+        }
+
+        {
+                TRACE_SCOPE("tick.collision");
+
+                // Stationary players cannot touch a coin they were not already touching, so they are only
+                // re-tested while a pickup is deferred; coins spawning on top of a player are handled in spawn_coin()
+                for (uint32_t i = 0; i < n; ++i)
+                {
+                        // Actual displacement, so clamping at the map edge reads as stopping
+                        players_.vx[i] = (players_.x[i] - prev_x_[i]) * static_cast<float>(TICK_RATE);
+                        players_.vy[i] = (players_.y[i] - prev_y_[i]) * static_cast<float>(TICK_RATE);
+                        if (!moved_[i] && !players_.pickup_deferred[i])
+                                continue;
+
+                        if (moved_[i])
+                        {
+                                player_grid_.move(players_.id[i],
+                                                  protocol::Vec2(prev_x_[i], prev_y_[i]),
+                                                  players_.position(i));
+                        }
+                        players_.pickup_deferred[i] = collect_coins(i, tick_inputs_[i]);
+                }
+        }
+
+        ++tick_;
+
+        // Coin spawning is counted in ticks so it stays locked to the simulation
+        if (tick_ % COIN_SPAWN_INTERVAL_TICKS == 0)
+        {
+                spawn_coin(tick_);
+        }
+
+        if (match_log_)
+                match_log_->end_tick(static_cast<uint32_t>(tick_), state_hash());
 }
 
-void GameSession::spawn_coin()
+void GameSession::spawn_coin(uint64_t shown_tick)
 {
+        TRACE_SCOPE("tick.spawn_coin");
         std::uniform_real_distribution<float> dist_x(COIN_RADIUS, MAP_WIDTH - COIN_RADIUS);
         std::uniform_real_distribution<float> dist_y(COIN_RADIUS, MAP_HEIGHT - COIN_RADIUS);
 
@@ -143,68 +267,75 @@ void GameSession::spawn_coin()
         coin.position.x = dist_x(rng_);
         coin.position.y = dist_y(rng_);
 
-        coins_[coin.id] = coin;
-        std::cout << "Spawned coin " << coin.id << " at (" << coin.position.x << ", " << coin.position.y << ")\n";
-}
-
-void GameSession::schedule_coin_spawn()
-{
-        if (!game_running_)
-                return;
+        coins_.add(coin.id, coin.position, shown_tick);
+        coin_grid_.insert(coin.id, coin.position);
+        LOG_DEBUG("Spawned coin {} at ({}, {})", coin.id, coin.position.x, coin.position.y);
 
-        coin_spawn_timer_.expires_after(std::chrono::seconds(3));
-        coin_spawn_timer_.async_wait(
-            [self = shared_from_this()](auto ec)
-            {
-                    if (!ec && self->game_running_)
-                    {
-                            self->spawn_coin();
-                            // Schedule next spawn (infinite loop)
-                            self->schedule_coin_spawn();
-                    }
-            });
-}
-
-bool GameSession::check_coin_collision(uint32_t player_id, uint32_t coin_id)
-{
-        auto pit = players_.find(player_id);
-        auto cit = coins_.find(coin_id);
-        if (pit == players_.end() || cit == coins_.end())
-                return false;
-
-        const auto& ppos = pit->second.position;
-        const auto& cpos = cit->second.position;
-
-        float dx         = ppos.x - cpos.x;
-        float dy         = ppos.y - cpos.y;
-        float dist_sq    = dx * dx + dy * dy;
-        float threshold  = (PLAYER_RADIUS + COIN_RADIUS);
-
-        return dist_sq < (threshold * threshold);
+        // A coin that lands on a player is picked up straight away
+        collected_.clear();
+        player_grid_.collect_within(coin.position, PICKUP_DIST, collected_);
+        if (!collected_.empty())
+        {
+                uint32_t i = players_.find(collected_.front());
+                award_coin(i, coin.id, players_.last_input_ts[i]);
+        }
 }
 
 protocol::MessageBuffer GameSession::create_state_message()
 {
+        TRACE_SCOPE("snapshot.serialize");
         protocol::MessageBuffer buf;
         buf.write_header(protocol::MessageType::SERVER_GAME_STATE);
 
-        auto now           = std::chrono::steady_clock::now();
-        uint32_t timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
-        buf.write_uint32(timestamp);
+        buf.write_uint32(clock_->now_ms());
+        buf.write_uint32(static_cast<uint32_t>(tick_));
 
         buf.data.push_back(static_cast<uint8_t>(players_.size()));
         buf.data.push_back(static_cast<uint8_t>(coins_.size()));
 
-        for (const auto& [id, player] : players_)
+        // Dense arrays: iteration order is deterministic and cache friendly
+        for (uint32_t i = 0; i < players_.size(); ++i)
         {
-                buf.write_player_state(player);
+                buf.write_player_state(protocol::PlayerState{players_.id[i],
+                                                             players_.position(i),
+                                                             players_.velocity(i),
+                                                             players_.score[i],
+                                                             players_.last_input_seq[i],
+                                                             players_.last_input_ts[i]});
         }
 
-        for (const auto& [id, coin] : coins_)
+        for (uint32_t i = 0; i < coins_.size(); ++i)
         {
-                buf.write_coin_state(coin);
+                buf.write_coin_state(protocol::CoinState{coins_.id[i], coins_.position(i)});
         }
 
         buf.finalize();
         return buf;
+}
+
+uint64_t GameSession::state_hash() const
+{
+        Fnv1a h;
+        h.u64(tick_);
+        h.u32(next_coin_id_);
+
+        h.u32(static_cast<uint32_t>(players_.size()));
+        for (uint32_t i = 0; i < players_.size(); ++i)
+        {
+                h.u32(players_.id[i]);
+                h.f32(players_.x[i]);
+                h.f32(players_.y[i]);
+                h.u32(players_.score[i]);
+                h.u32(players_.last_input_seq[i]);
+        }
+
+        h.u32(static_cast<uint32_t>(coins_.size()));
+        for (uint32_t i = 0; i < coins_.size(); ++i)
+        {
+                h.u32(coins_.id[i]);
+                h.f32(coins_.x[i]);
+                h.f32(coins_.y[i]);
+        }
+
+        return h.value;
 }
\ No newline at end of file
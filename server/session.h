@@ -7,24 +7,66 @@
 
 #pragma once
 #include "protocol.h"
-#include <asio.hpp>
+#include "movement.h"
+#include "mpsc_queue.h"
+#include "entity_store.h"
+#include "spatial_grid.h"
+#include "clock.h"
+#include "match_log.h"
 #include <memory>
-#include <unordered_map>
 #include <random>
 #include <chrono>
 
 /**
  * @class GameSession
  * @brief Manages game logic including player movement, coin spawning, and collision detection
+ *
+ * The simulation advances in fixed timesteps of TICK_DT. Each tick drains the
+ * network ingestion queue into per-player input queues, consumes exactly one input
+ * per player, then runs movement and coin collision. Movement therefore depends
+ * only on the number of inputs consumed, never on when packets happened to arrive.
+ *
+ * Players and coins live in dense structure-of-arrays stores, so movement,
+ * collision and serialization are linear walks over contiguous memory.
+ *
+ * Each coin remembers the first tick whose snapshot shows it. Coins never move,
+ * so the only way the world a client acted on differs from the live one is a
+ * coin spawned after the snapshot tick the client acknowledged in its input;
+ * such pickups are rejected, so a player is never credited for a coin its
+ * client had not been shown yet.
+ *
+ * The session owns no timers: whoever drives it (GameServer's TickScheduler, or
+ * a Simulator in virtual time) calls tick() once per TICK_DT. Time and randomness
+ * are injected, so a session built with a VirtualClock and a fixed seed evolves
+ * identically for identical inputs; state_hash() makes that checkable.
  */
-class GameSession : public std::enable_shared_from_this<GameSession>
+class GameSession
 {
 public:
+        static constexpr uint32_t TICK_RATE = movement::TICK_RATE;  ///< Simulation ticks per second
+        static constexpr float TICK_DT      = movement::TICK_DT;    ///< Fixed simulation timestep (seconds)
+
+        /**
+         * @brief Convert a snapshot rate to a broadcast interval
+         * @param hz Snapshots per second (clamped to 1..TICK_RATE)
+         * @return Ticks between snapshots (the rate is rounded down to a whole number of ticks)
+         */
+        static constexpr uint32_t broadcast_interval_ticks(uint32_t hz)
+        {
+                return TICK_RATE / (hz < 1 ? 1 : hz > TICK_RATE ? TICK_RATE : hz);
+        }
+
+        /**
+         * @brief Construct game session on wall-clock time with a random seed
+         */
+        GameSession();
+
         /**
-         * @brief Construct game session
-         * @param io ASIO I/O context for timers
+         * @brief Construct game session with an injected clock and seed
+         * @param clock Time source for snapshot and lag timestamps
+         * @param seed Seed for coin spawning
          */
-        GameSession(asio::io_context& io);
+        GameSession(std::shared_ptr<const Clock> clock, uint32_t seed);
 
         /**
          * @brief Add a player to the game
@@ -39,17 +81,64 @@ public:
         void remove_player(uint32_t player_id);
 
         /**
-         * @brief Process player input and update game state
+         * @brief Queue player input for the next simulation tick
          * @param player_id Player ID
          * @param input Input data from client
+         * @return true if queued, false if the ingestion queue was full and the input was dropped
+         * @note Safe to call from any network thread; never blocks on simulation work
          */
-        void process_input(uint32_t player_id, const protocol::ClientInput& input);
+        bool push_input(uint32_t player_id, const protocol::ClientInput& input);
 
         /**
          * @brief Start the game session
          */
         void start();
 
+        /**
+         * @brief Advance the simulation by one fixed timestep
+         * @note No-op until start() has been called
+         */
+        void tick();
+
+        /**
+         * @brief Get number of simulation ticks run so far
+         * @return Tick counter
+         */
+        uint64_t current_tick() const { return tick_; }
+
+        /**
+         * @brief Get the RNG seed this session was created with
+         * @return Seed
+         */
+        uint32_t seed() const { return seed_; }
+
+        /**
+         * @brief Get the sequence number of the newest input applied for a player
+         * @param player_id Player ID
+         * @return Last applied input seq, 0 if none yet or the player is unknown
+         */
+        uint32_t last_input_seq(uint32_t player_id) const;
+
+        /**
+         * @brief Get the number of inputs waiting in the ingestion queue
+         * @return Queue depth
+         * @note Call from the thread that calls tick()
+         */
+        size_t pending_inputs() const { return input_queue_.size_approx(); }
+
+        /**
+         * @brief Hash the authoritative simulation state
+         * @return 64-bit FNV-1a hash of the tick, players and coins (bit-exact positions)
+         */
+        uint64_t state_hash() const;
+
+        /**
+         * @brief Record joins, leaves, drained inputs and per-tick state hashes
+         * @param log Log to append to (nullptr stops recording)
+         * @note Attach before the first player joins so the log can be replayed from the start
+         */
+        void set_match_log(std::shared_ptr<MatchLog> log) { match_log_ = std::move(log); }
+
         /**
          * @brief Create game state message for broadcasting
          * @return Serialized game state message
@@ -57,26 +146,56 @@ public:
         protocol::MessageBuffer create_state_message();
 
 private:
-        void update_game_logic();
-        void spawn_coin();
-        void schedule_coin_spawn();
-        bool check_coin_collision(uint32_t player_id, uint32_t coin_id);
+        /**
+         * @struct QueuedInput
+         * @brief Decoded client input waiting to be applied by the simulation
+         */
+        struct QueuedInput
+        {
+                uint32_t player_id;
+                protocol::ClientInput input;
+        };
+
+        void drain_inputs();
+        bool collect_coins(uint32_t index, const protocol::ClientInput& input);
+        void award_coin(uint32_t index, uint32_t coin_id, uint32_t input_ts);
+        void spawn_coin(uint64_t shown_tick);
+
+        PlayerStore players_;  ///< Dense player state, including per-player input queues
+        CoinStore coins_;      ///< Dense coin state
+
+        SpatialGrid coin_grid_;            ///< Coins bucketed by position for broad-phase collision
+        SpatialGrid player_grid_;          ///< Players bucketed by position, queried when a coin spawns
+        std::vector<uint32_t> collected_;  ///< Scratch list of entities hit by an overlap query
 
-        asio::io_context& io_;
-        asio::steady_timer update_timer_;
-        asio::steady_timer coin_spawn_timer_;
+        // Per-tick scratch arrays, parallel to players_ (kept to avoid reallocating every tick)
+        std::vector<protocol::ClientInput> tick_inputs_;  ///< Input consumed by each player this tick
+        std::vector<float> input_dx_;                     ///< Input direction X, SoA for the movement kernel
+        std::vector<float> input_dy_;                     ///< Input direction Y, SoA for the movement kernel
+        std::vector<float> prev_x_;                       ///< Position X before integration (for grid updates)
+        std::vector<float> prev_y_;                       ///< Position Y before integration (for grid updates)
+        std::vector<uint8_t> moved_;                      ///< 1 if the player moved this tick
 
-        std::unordered_map<uint32_t, protocol::PlayerState> players_;
-        std::unordered_map<uint32_t, protocol::CoinState> coins_;
+        MpscQueue<QueuedInput> input_queue_;   ///< Inputs pushed by connections, drained at the start of each tick
+        std::shared_ptr<MatchLog> match_log_;  ///< Optional match recording
+
+        std::shared_ptr<const Clock> clock_;  ///< Time source (wall clock or virtual)
+        uint32_t seed_;                       ///< Seed rng_ was initialised with
 
         uint32_t next_coin_id_;
         std::mt19937 rng_;
-        std::chrono::steady_clock::time_point last_update_;
-
-        bool game_running_;                  ///< Whether the game is currently running
-        const float MAP_WIDTH     = 800.0f;  ///< Game world width
-        const float MAP_HEIGHT    = 600.0f;  ///< Game world height
-        const float PLAYER_SPEED  = 200.0f;  ///< Player movement speed (pixels/second)
-        const float COIN_RADIUS   = 20.0f;   ///< Coin collision radius
-        const float PLAYER_RADIUS = 25.0f;   ///< Player collision radius
+        uint64_t tick_;  ///< Number of simulation ticks run so far
+
+        bool game_running_;  ///< Whether the game is currently running
+
+        // World constants shared with client prediction (common/movement.h)
+        static constexpr float MAP_WIDTH     = movement::MAP_WIDTH;
+        static constexpr float MAP_HEIGHT    = movement::MAP_HEIGHT;
+        static constexpr float COIN_RADIUS   = movement::COIN_RADIUS;
+        static constexpr float PLAYER_RADIUS = movement::PLAYER_RADIUS;
+        static constexpr float PICKUP_DIST   = movement::PICKUP_DIST;  ///< Centre distance for a pickup
+        static constexpr float GRID_CELL     = PICKUP_DIST;            ///< Cell size = collision distance
+
+        static constexpr size_t INPUT_QUEUE_CAPACITY       = 4096;            ///< Max inputs buffered between ticks
+        static constexpr uint64_t COIN_SPAWN_INTERVAL_TICKS = 3 * TICK_RATE;  ///< Spawn a coin every 3 seconds
 };
\ No newline at end of file
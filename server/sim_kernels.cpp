@@ -0,0 +1,223 @@
+#include "sim_kernels.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SIM_KERNELS_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIM_KERNELS_SSE2 1
+#endif
+
+namespace sim
+{
+
+        namespace
+        {
+                // Scalar bodies shared by the reference functions and the SIMD remainder loops.
+                // Operation order must match the vector code exactly.
+                inline uint8_t integrate_one(float& x, float& y, float dx, float dy, const MoveParams& p)
+                {
+                        return movement::step(x, y, dx, dy, p) ? 1 : 0;
+                }
+
+                inline bool overlap_one(float px, float py, float cx, float cy, float radius_sq)
+                {
+                        float dx = px - cx;
+                        float dy = py - cy;
+                        return dx * dx + dy * dy < radius_sq;
+                }
+        }  // namespace
+
+        void integrate_scalar(float* x,
+                              float* y,
+                              const float* dx,
+                              const float* dy,
+                              uint8_t* moved,
+                              size_t n,
+                              const MoveParams& p)
+        {
+                for (size_t i = 0; i < n; ++i)
+                        moved[i] = integrate_one(x[i], y[i], dx[i], dy[i], p);
+        }
+
+        size_t overlaps_scalar(float px,
+                               float py,
+                               const float* xs,
+                               const float* ys,
+                               size_t n,
+                               float radius_sq,
+                               uint32_t* out)
+        {
+                size_t count = 0;
+                for (size_t i = 0; i < n; ++i)
+                {
+                        if (overlap_one(px, py, xs[i], ys[i], radius_sq))
+                                out[count++] = static_cast<uint32_t>(i);
+                }
+                return count;
+        }
+
+#if defined(SIM_KERNELS_AVX2)
+
+        void integrate(float* x, float* y, const float* dx, const float* dy, uint8_t* moved, size_t n, const MoveParams& p)
+        {
+                const __m256 speed    = _mm256_set1_ps(p.speed);
+                const __m256 dt       = _mm256_set1_ps(p.dt);
+                const __m256 deadzone = _mm256_set1_ps(p.deadzone);
+                const __m256 min_x    = _mm256_set1_ps(p.min_x);
+                const __m256 max_x    = _mm256_set1_ps(p.max_x);
+                const __m256 min_y    = _mm256_set1_ps(p.min_y);
+                const __m256 max_y    = _mm256_set1_ps(p.max_y);
+
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                        __m256 vdx  = _mm256_loadu_ps(dx + i);
+                        __m256 vdy  = _mm256_loadu_ps(dy + i);
+                        __m256 len  = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(vdx, vdx), _mm256_mul_ps(vdy, vdy)));
+                        __m256 mask = _mm256_cmp_ps(len, deadzone, _CMP_GT_OQ);
+
+                        __m256 vx   = _mm256_loadu_ps(x + i);
+                        __m256 vy   = _mm256_loadu_ps(y + i);
+                        __m256 nx   = _mm256_div_ps(vdx, len);
+                        __m256 ny   = _mm256_div_ps(vdy, len);
+                        __m256 tx   = _mm256_add_ps(vx, _mm256_mul_ps(_mm256_mul_ps(nx, speed), dt));
+                        __m256 ty   = _mm256_add_ps(vy, _mm256_mul_ps(_mm256_mul_ps(ny, speed), dt));
+                        tx          = _mm256_max_ps(_mm256_min_ps(tx, max_x), min_x);
+                        ty          = _mm256_max_ps(_mm256_min_ps(ty, max_y), min_y);
+
+                        _mm256_storeu_ps(x + i, _mm256_blendv_ps(vx, tx, mask));
+                        _mm256_storeu_ps(y + i, _mm256_blendv_ps(vy, ty, mask));
+
+                        int bits = _mm256_movemask_ps(mask);
+                        for (int k = 0; k < 8; ++k)
+                                moved[i + k] = static_cast<uint8_t>((bits >> k) & 1);
+                }
+
+                for (; i < n; ++i)
+                        moved[i] = integrate_one(x[i], y[i], dx[i], dy[i], p);
+        }
+
+        size_t overlaps(float px, float py, const float* xs, const float* ys, size_t n, float radius_sq, uint32_t* out)
+        {
+                const __m256 vpx = _mm256_set1_ps(px);
+                const __m256 vpy = _mm256_set1_ps(py);
+                const __m256 vr2 = _mm256_set1_ps(radius_sq);
+
+                size_t count = 0;
+                size_t i     = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                        __m256 ddx = _mm256_sub_ps(vpx, _mm256_loadu_ps(xs + i));
+                        __m256 ddy = _mm256_sub_ps(vpy, _mm256_loadu_ps(ys + i));
+                        __m256 d2  = _mm256_add_ps(_mm256_mul_ps(ddx, ddx), _mm256_mul_ps(ddy, ddy));
+                        int bits   = _mm256_movemask_ps(_mm256_cmp_ps(d2, vr2, _CMP_LT_OQ));
+                        for (int k = 0; bits; ++k, bits >>= 1)
+                        {
+                                if (bits & 1)
+                                        out[count++] = static_cast<uint32_t>(i + k);
+                        }
+                }
+
+                for (; i < n; ++i)
+                {
+                        if (overlap_one(px, py, xs[i], ys[i], radius_sq))
+                                out[count++] = static_cast<uint32_t>(i);
+                }
+                return count;
+        }
+
+        const char* backend() { return "avx2"; }
+
+#elif defined(SIM_KERNELS_SSE2)
+
+        void integrate(float* x, float* y, const float* dx, const float* dy, uint8_t* moved, size_t n, const MoveParams& p)
+        {
+                const __m128 speed    = _mm_set1_ps(p.speed);
+                const __m128 dt       = _mm_set1_ps(p.dt);
+                const __m128 deadzone = _mm_set1_ps(p.deadzone);
+                const __m128 min_x    = _mm_set1_ps(p.min_x);
+                const __m128 max_x    = _mm_set1_ps(p.max_x);
+                const __m128 min_y    = _mm_set1_ps(p.min_y);
+                const __m128 max_y    = _mm_set1_ps(p.max_y);
+
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                        __m128 vdx  = _mm_loadu_ps(dx + i);
+                        __m128 vdy  = _mm_loadu_ps(dy + i);
+                        __m128 len  = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(vdx, vdx), _mm_mul_ps(vdy, vdy)));
+                        __m128 mask = _mm_cmpgt_ps(len, deadzone);
+
+                        __m128 vx   = _mm_loadu_ps(x + i);
+                        __m128 vy   = _mm_loadu_ps(y + i);
+                        __m128 nx   = _mm_div_ps(vdx, len);
+                        __m128 ny   = _mm_div_ps(vdy, len);
+                        __m128 tx   = _mm_add_ps(vx, _mm_mul_ps(_mm_mul_ps(nx, speed), dt));
+                        __m128 ty   = _mm_add_ps(vy, _mm_mul_ps(_mm_mul_ps(ny, speed), dt));
+                        tx          = _mm_max_ps(_mm_min_ps(tx, max_x), min_x);
+                        ty          = _mm_max_ps(_mm_min_ps(ty, max_y), min_y);
+
+                        // SSE2 has no blendv: select with and/andnot/or
+                        _mm_storeu_ps(x + i, _mm_or_ps(_mm_and_ps(mask, tx), _mm_andnot_ps(mask, vx)));
+                        _mm_storeu_ps(y + i, _mm_or_ps(_mm_and_ps(mask, ty), _mm_andnot_ps(mask, vy)));
+
+                        int bits = _mm_movemask_ps(mask);
+                        for (int k = 0; k < 4; ++k)
+                                moved[i + k] = static_cast<uint8_t>((bits >> k) & 1);
+                }
+
+                for (; i < n; ++i)
+                        moved[i] = integrate_one(x[i], y[i], dx[i], dy[i], p);
+        }
+
+        size_t overlaps(float px, float py, const float* xs, const float* ys, size_t n, float radius_sq, uint32_t* out)
+        {
+                const __m128 vpx = _mm_set1_ps(px);
+                const __m128 vpy = _mm_set1_ps(py);
+                const __m128 vr2 = _mm_set1_ps(radius_sq);
+
+                size_t count = 0;
+                size_t i     = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                        __m128 ddx = _mm_sub_ps(vpx, _mm_loadu_ps(xs + i));
+                        __m128 ddy = _mm_sub_ps(vpy, _mm_loadu_ps(ys + i));
+                        __m128 d2  = _mm_add_ps(_mm_mul_ps(ddx, ddx), _mm_mul_ps(ddy, ddy));
+                        int bits   = _mm_movemask_ps(_mm_cmplt_ps(d2, vr2));
+                        for (int k = 0; bits; ++k, bits >>= 1)
+                        {
+                                if (bits & 1)
+                                        out[count++] = static_cast<uint32_t>(i + k);
+                        }
+                }
+
+                for (; i < n; ++i)
+                {
+                        if (overlap_one(px, py, xs[i], ys[i], radius_sq))
+                                out[count++] = static_cast<uint32_t>(i);
+                }
+                return count;
+        }
+
+        const char* backend() { return "sse2"; }
+
+#else
+
+        void integrate(float* x, float* y, const float* dx, const float* dy, uint8_t* moved, size_t n, const MoveParams& p)
+        {
+                integrate_scalar(x, y, dx, dy, moved, n, p);
+        }
+
+        size_t overlaps(float px, float py, const float* xs, const float* ys, size_t n, float radius_sq, uint32_t* out)
+        {
+                return overlaps_scalar(px, py, xs, ys, n, radius_sq, out);
+        }
+
+        const char* backend() { return "scalar"; }
+
+#endif
+
+}  // namespace sim
@@ -0,0 +1,92 @@
+/**
+ * @file sim_kernels.h
+ * @brief Vectorized movement integration and overlap kernels over SoA arrays
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include "movement.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @namespace sim
+ * @brief Data-parallel simulation kernels
+ *
+ * Each kernel has a scalar reference implementation and a SIMD implementation
+ * (AVX2 when built with ENABLE_AVX2, SSE2 otherwise on x86, scalar elsewhere).
+ * The SIMD paths perform exactly the same IEEE operations in the same order as
+ * the scalar ones (sqrt and division are correctly rounded in both), so results
+ * are bit-identical. This relies on floating-point contraction being disabled
+ * for the simulation sources (-ffp-contract=off), which CMake enforces.
+ */
+namespace sim
+{
+
+        using MoveParams = movement::Params;  ///< Constants for movement integration
+
+        /**
+         * @brief Integrate positions from direction inputs (SIMD)
+         *
+         * For each i: movement::step(x[i], y[i], dx[i], dy[i], p), the same step
+         * the client predicts with.
+         *
+         * @param x Position X (updated in place)
+         * @param y Position Y (updated in place)
+         * @param dx Input direction X
+         * @param dy Input direction Y
+         * @param moved Output: 1 if entity i moved, else 0
+         * @param n Number of entities
+         * @param p Movement constants
+         */
+        void integrate(float* x,
+                       float* y,
+                       const float* dx,
+                       const float* dy,
+                       uint8_t* moved,
+                       size_t n,
+                       const MoveParams& p);
+
+        /**
+         * @brief Scalar reference for integrate()
+         */
+        void integrate_scalar(float* x,
+                              float* y,
+                              const float* dx,
+                              const float* dy,
+                              uint8_t* moved,
+                              size_t n,
+                              const MoveParams& p);
+
+        /**
+         * @brief Find circles overlapping a point (SIMD)
+         * @param px Query X
+         * @param py Query Y
+         * @param xs Circle centers X
+         * @param ys Circle centers Y
+         * @param n Number of circles
+         * @param radius_sq Squared overlap distance (strict less-than)
+         * @param out Output indices in ascending order (capacity >= n)
+         * @return Number of overlapping circles written to out
+         */
+        size_t overlaps(float px, float py, const float* xs, const float* ys, size_t n, float radius_sq, uint32_t* out);
+
+        /**
+         * @brief Scalar reference for overlaps()
+         */
+        size_t overlaps_scalar(float px,
+                               float py,
+                               const float* xs,
+                               const float* ys,
+                               size_t n,
+                               float radius_sq,
+                               uint32_t* out);
+
+        /**
+         * @brief Get name of the compiled SIMD backend
+         * @return "avx2", "sse2" or "scalar"
+         */
+        const char* backend();
+
+}  // namespace sim
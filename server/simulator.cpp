@@ -0,0 +1,85 @@
+#include "simulator.h"
+#include <chrono>
+
+Simulator::Simulator(uint32_t seed, std::shared_ptr<MatchLog> log)
+    : clock_(std::make_shared<VirtualClock>()),
+      session_(std::make_unique<GameSession>(clock_, seed)),
+      last_snapshot_tick_(0)
+{
+        session_->set_match_log(std::move(log));
+        session_->start();
+}
+
+void Simulator::add_player(uint32_t player_id)
+{
+        session_->add_player(player_id);
+        players_.push_back(Player{player_id, 1});
+}
+
+Simulator::Result Simulator::run(uint64_t ticks, const InputScript& script, uint32_t broadcast_interval_ticks)
+{
+        // 1e6 / 60 is not integral; accumulate the remainder so virtual time tracks ticks exactly
+        const uint64_t period_us = 1000000 / GameSession::TICK_RATE;
+        const uint64_t rem_us    = 1000000 % GameSession::TICK_RATE;
+        uint64_t rem_acc         = 0;
+
+        Result result;
+        auto wall_start = std::chrono::steady_clock::now();
+
+        for (uint64_t t = 0; t < ticks; ++t)
+        {
+                const uint64_t tick = session_->current_tick();
+                for (Player& player : players_)
+                {
+                        protocol::ClientInput input{0.0f, 0.0f, 0, 0, 0};
+                        if (!script(tick, player.id, input))
+                                continue;
+
+                        input.timestamp = clock_->now_ms();
+                        input.seq       = player.next_seq++;
+                        input.ack_tick  = last_snapshot_tick_;
+                        session_->push_input(player.id, input);
+                }
+
+                session_->tick();
+
+                rem_acc += rem_us;
+                clock_->advance_us(period_us + rem_acc / GameSession::TICK_RATE);
+                rem_acc %= GameSession::TICK_RATE;
+
+                if (broadcast_interval_ticks && session_->current_tick() % broadcast_interval_ticks == 0)
+                {
+                        protocol::MessageBuffer msg = session_->create_state_message();
+                        result.snapshots++;
+                        result.snapshot_bytes += msg.data.size();
+                        last_snapshot_tick_ = static_cast<uint32_t>(session_->current_tick());
+                }
+        }
+
+        result.ticks        = ticks;
+        result.state_hash   = session_->state_hash();
+        result.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+        return result;
+}
+
+Simulator::InputScript Simulator::random_walk(uint32_t seed)
+{
+        return [seed](uint64_t tick, uint32_t player_id, protocol::ClientInput& out)
+        {
+                // Stateless mix of (seed, player, half-second slot) so scripts replay identically
+                uint64_t x = (static_cast<uint64_t>(seed) << 32) ^ (static_cast<uint64_t>(player_id) * 0x9E3779B97F4A7C15ull) ^
+                             (tick / (GameSession::TICK_RATE / 2));
+                x ^= x >> 33;
+                x *= 0xFF51AFD7ED558CCDull;
+                x ^= x >> 33;
+
+                // Eight compass directions plus standing still
+                static const float dirs[9][2] = {
+                    {0.0f, 0.0f}, {1.0f, 0.0f}, {-1.0f, 0.0f}, {0.0f, 1.0f}, {0.0f, -1.0f},
+                    {1.0f, 1.0f}, {1.0f, -1.0f}, {-1.0f, 1.0f}, {-1.0f, -1.0f}};
+                const float* d = dirs[x % 9];
+                out.dx         = d[0];
+                out.dy         = d[1];
+                return true;
+        };
+}
@@ -0,0 +1,108 @@
+/**
+ * @file simulator.h
+ * @brief Headless virtual-time driver for GameSession
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include "session.h"
+#include "clock.h"
+#include "match_log.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @class Simulator
+ * @brief Runs a GameSession back to back in virtual time with scripted inputs
+ *
+ * No sockets and no timers: each step feeds one scripted input per player,
+ * ticks the session, advances a VirtualClock by one TICK_DT and, every
+ * broadcast interval, serializes a snapshot exactly as the server would. A run
+ * is a pure function of the seed and the script, so the final state_hash() can
+ * be compared across runs and builds.
+ */
+class Simulator
+{
+public:
+        /**
+         * @brief Input script callback
+         *
+         * Called once per player per tick before the tick runs. Fill dx/dy and
+         * return true to send an input, or return false to send nothing.
+         * Timestamp, seq and ack_tick are filled in by the simulator.
+         */
+        using InputScript = std::function<bool(uint64_t tick, uint32_t player_id, protocol::ClientInput& out)>;
+
+        /**
+         * @struct Result
+         * @brief Outcome of a run
+         */
+        struct Result
+        {
+                uint64_t ticks          = 0;    ///< Ticks simulated
+                uint64_t state_hash     = 0;    ///< GameSession::state_hash() after the last tick
+                uint64_t snapshots      = 0;    ///< State messages serialized
+                uint64_t snapshot_bytes = 0;    ///< Total size of those messages
+                double wall_seconds     = 0.0;  ///< Real time the run took
+
+                /**
+                 * @brief Get simulation speed
+                 * @return Ticks per wall-clock second
+                 */
+                double ticks_per_second() const { return wall_seconds > 0.0 ? ticks / wall_seconds : 0.0; }
+        };
+
+        /**
+         * @brief Construct simulator and start the session
+         * @param seed Seed for the session RNG
+         * @param log Optional match log to record the run into
+         */
+        explicit Simulator(uint32_t seed, std::shared_ptr<MatchLog> log = nullptr);
+
+        /**
+         * @brief Add a player
+         * @param player_id Unique player ID
+         */
+        void add_player(uint32_t player_id);
+
+        /**
+         * @brief Simulate a number of ticks
+         * @param ticks Ticks to run
+         * @param script Input source
+         * @param broadcast_interval_ticks Serialize a snapshot every this many ticks (0 = never)
+         * @return Run result
+         */
+        Result run(uint64_t ticks, const InputScript& script, uint32_t broadcast_interval_ticks = 3);
+
+        /**
+         * @brief Get the simulated session
+         * @return Session
+         */
+        GameSession& session() { return *session_; }
+
+        /**
+         * @brief Script where every player walks in a direction that changes every half second
+         * @param seed Seed for the walk; directions depend only on (seed, player, tick)
+         * @return Input script
+         */
+        static InputScript random_walk(uint32_t seed);
+
+private:
+        /**
+         * @struct Player
+         * @brief Client-side bookkeeping for one simulated player
+         */
+        struct Player
+        {
+                uint32_t id;
+                uint32_t next_seq;
+        };
+
+        std::shared_ptr<VirtualClock> clock_;
+        std::unique_ptr<GameSession> session_;
+        std::vector<Player> players_;
+        uint32_t last_snapshot_tick_;  ///< Tick of the newest serialized snapshot, echoed as ack_tick
+};
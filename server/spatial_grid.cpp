@@ -0,0 +1,104 @@
+#include "spatial_grid.h"
+#include "sim_kernels.h"
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float width, float height, float cell_size)
+    : cols_(std::max(1, static_cast<int>(std::ceil(width / cell_size)))),
+      rows_(std::max(1, static_cast<int>(std::ceil(height / cell_size)))),
+      inv_cell_size_(1.0f / cell_size),
+      cells_(static_cast<size_t>(cols_) * rows_)
+{
+}
+
+void SpatialGrid::insert(uint32_t id, const protocol::Vec2& pos)
+{
+        Cell& cell = cells_[cell_index(pos)];
+        cell.ids.push_back(id);
+        cell.xs.push_back(pos.x);
+        cell.ys.push_back(pos.y);
+}
+
+bool SpatialGrid::remove(uint32_t id, const protocol::Vec2& pos)
+{
+        Cell& cell = cells_[cell_index(pos)];
+        for (size_t i = 0; i < cell.ids.size(); ++i)
+        {
+                if (cell.ids[i] == id)
+                {
+                        // Swap-and-pop: order within a cell is irrelevant
+                        cell.ids[i] = cell.ids.back();
+                        cell.xs[i]  = cell.xs.back();
+                        cell.ys[i]  = cell.ys.back();
+                        cell.ids.pop_back();
+                        cell.xs.pop_back();
+                        cell.ys.pop_back();
+                        return true;
+                }
+        }
+        return false;
+}
+
+void SpatialGrid::move(uint32_t id, const protocol::Vec2& old_pos, const protocol::Vec2& new_pos)
+{
+        size_t from = cell_index(old_pos);
+        size_t to   = cell_index(new_pos);
+
+        if (from == to)
+        {
+                Cell& cell = cells_[from];
+                for (size_t i = 0; i < cell.ids.size(); ++i)
+                {
+                        if (cell.ids[i] == id)
+                        {
+                                cell.xs[i] = new_pos.x;
+                                cell.ys[i] = new_pos.y;
+                                return;
+                        }
+                }
+        }
+
+        remove(id, old_pos);
+        insert(id, new_pos);
+}
+
+void SpatialGrid::clear()
+{
+        for (Cell& cell : cells_)
+        {
+                cell.ids.clear();
+                cell.xs.clear();
+                cell.ys.clear();
+        }
+}
+
+void SpatialGrid::collect_within(const protocol::Vec2& center, float radius, std::vector<uint32_t>& out) const
+{
+        int x0 = cell_coord(center.x - radius, cols_);
+        int x1 = cell_coord(center.x + radius, cols_);
+        int y0 = cell_coord(center.y - radius, rows_);
+        int y1 = cell_coord(center.y + radius, rows_);
+
+        for (int cy = y0; cy <= y1; ++cy)
+        {
+                for (int cx = x0; cx <= x1; ++cx)
+                {
+                        const Cell& cell = cells_[static_cast<size_t>(cy) * cols_ + cx];
+                        if (cell.ids.empty())
+                                continue;
+
+                        // The kernel writes cell-local indices into the tail of out; map them to IDs in place
+                        size_t base = out.size();
+                        out.resize(base + cell.ids.size());
+                        size_t hits = sim::overlaps(center.x,
+                                                    center.y,
+                                                    cell.xs.data(),
+                                                    cell.ys.data(),
+                                                    cell.ids.size(),
+                                                    radius * radius,
+                                                    out.data() + base);
+                        for (size_t k = 0; k < hits; ++k)
+                                out[base + k] = cell.ids[out[base + k]];
+                        out.resize(base + hits);
+                }
+        }
+}
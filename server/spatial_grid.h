@@ -0,0 +1,135 @@
+/**
+ * @file spatial_grid.h
+ * @brief Uniform-grid spatial hash for broad-phase collision queries
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include "protocol.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class SpatialGrid
+ * @brief Buckets entities into fixed-size cells covering the map
+ *
+ * Each cell stores its entities as small parallel id / x / y arrays, so a
+ * query only touches the cells overlapping the search box, never has to look
+ * the entity up elsewhere, and can run the SIMD overlap kernel per cell. With
+ * a cell size of at least the largest query radius, a circle query visits at
+ * most 3x3 cells.
+ *
+ * Positions outside the map are clamped into the border cells.
+ */
+class SpatialGrid
+{
+public:
+        /**
+         * @struct Entry
+         * @brief Entity stored in a grid cell
+         */
+        struct Entry
+        {
+                uint32_t id;
+                protocol::Vec2 position;
+        };
+
+        /**
+         * @brief Construct spatial grid
+         * @param width World width
+         * @param height World height
+         * @param cell_size Cell edge length (should be >= the largest query radius)
+         */
+        SpatialGrid(float width, float height, float cell_size);
+
+        /**
+         * @brief Insert an entity
+         * @param id Entity ID
+         * @param pos Entity position
+         */
+        void insert(uint32_t id, const protocol::Vec2& pos);
+
+        /**
+         * @brief Remove an entity
+         * @param id Entity ID
+         * @param pos Position the entity was last inserted or moved at
+         * @return true if the entity was found and removed
+         */
+        bool remove(uint32_t id, const protocol::Vec2& pos);
+
+        /**
+         * @brief Update an entity's position, moving it between cells if needed
+         * @param id Entity ID
+         * @param old_pos Position the entity was last inserted or moved at
+         * @param new_pos New position
+         */
+        void move(uint32_t id, const protocol::Vec2& old_pos, const protocol::Vec2& new_pos);
+
+        /**
+         * @brief Remove all entities
+         */
+        void clear();
+
+        /**
+         * @brief Append the IDs of entities strictly closer than a distance to a point
+         * @param center Query center
+         * @param radius Overlap distance
+         * @param out Output list (appended to, in cell order)
+         */
+        void collect_within(const protocol::Vec2& center, float radius, std::vector<uint32_t>& out) const;
+
+        /**
+         * @brief Visit every entity in the cells overlapping a square around a point
+         * @param center Query center
+         * @param radius Half-size of the query square
+         * @param fn Callback invoked as fn(const Entry&); entries may lie outside the radius
+         */
+        template <typename Fn>
+        void query(const protocol::Vec2& center, float radius, Fn&& fn) const
+        {
+                int x0 = cell_coord(center.x - radius, cols_);
+                int x1 = cell_coord(center.x + radius, cols_);
+                int y0 = cell_coord(center.y - radius, rows_);
+                int y1 = cell_coord(center.y + radius, rows_);
+
+                for (int cy = y0; cy <= y1; ++cy)
+                {
+                        for (int cx = x0; cx <= x1; ++cx)
+                        {
+                                const Cell& cell = cells_[static_cast<size_t>(cy) * cols_ + cx];
+                                for (size_t i = 0; i < cell.ids.size(); ++i)
+                                        fn(Entry{cell.ids[i], protocol::Vec2(cell.xs[i], cell.ys[i])});
+                        }
+                }
+        }
+
+private:
+        /**
+         * @struct Cell
+         * @brief Entities in one cell as parallel arrays
+         */
+        struct Cell
+        {
+                std::vector<uint32_t> ids;
+                std::vector<float> xs;
+                std::vector<float> ys;
+        };
+
+        int cell_coord(float v, int count) const
+        {
+                int c = static_cast<int>(v * inv_cell_size_);
+                return std::max(0, std::min(count - 1, c));
+        }
+
+        size_t cell_index(const protocol::Vec2& pos) const
+        {
+                return static_cast<size_t>(cell_coord(pos.y, rows_)) * cols_ + cell_coord(pos.x, cols_);
+        }
+
+        int cols_;
+        int rows_;
+        float inv_cell_size_;
+        std::vector<Cell> cells_;  ///< Row-major cells
+};
@@ -0,0 +1,80 @@
+#include "tick_scheduler.h"
+#include "log.h"
+#include <algorithm>
+
+TickScheduler::TickScheduler(asio::io_context& io,
+                             std::chrono::nanoseconds period,
+                             TickHandler handler,
+                             OverloadPolicy policy,
+                             uint32_t max_catch_up)
+    : timer_(io),
+      period_(period),
+      handler_(std::move(handler)),
+      policy_(policy),
+      max_catch_up_(std::max<uint32_t>(1, max_catch_up)),
+      tick_(0),
+      running_(false)
+{
+}
+
+void TickScheduler::start()
+{
+        if (running_)
+                return;
+        running_       = true;
+        next_deadline_ = std::chrono::steady_clock::now() + period_;
+        schedule();
+}
+
+void TickScheduler::stop()
+{
+        running_ = false;
+        timer_.cancel();
+}
+
+void TickScheduler::schedule()
+{
+        timer_.expires_at(next_deadline_);
+        timer_.async_wait(
+            [this](asio::error_code ec)
+            {
+                    if (!ec && running_)
+                            on_timer();
+            });
+}
+
+void TickScheduler::on_timer()
+{
+        auto now      = std::chrono::steady_clock::now();
+        auto lateness = std::chrono::duration_cast<std::chrono::microseconds>(now - next_deadline_).count();
+        lateness      = std::max<int64_t>(0, lateness);
+
+        stats_.wakeups++;
+        stats_.total_jitter_us += lateness;
+        stats_.max_jitter_us    = std::max(stats_.max_jitter_us, static_cast<int64_t>(lateness));
+        if (std::chrono::microseconds(lateness) >= period_)
+                stats_.late_wakeups++;
+
+        uint32_t budget = (policy_ == OverloadPolicy::CATCH_UP) ? max_catch_up_ : 1;
+        uint32_t ran    = 0;
+        while (running_ && next_deadline_ <= now && ran < budget)
+        {
+                handler_(tick_++);
+                next_deadline_ += period_;
+                stats_.ticks_run++;
+                ran++;
+        }
+
+        // Still behind after spending the budget: drop the missed deadlines so we
+        // resume on the original grid instead of spiralling further behind.
+        if (next_deadline_ <= now)
+        {
+                uint64_t missed = static_cast<uint64_t>((now - next_deadline_) / period_) + 1;
+                next_deadline_       += period_ * missed;
+                stats_.ticks_skipped += missed;
+                LOG_WARN("Tick scheduler overloaded, skipped {} tick(s)", missed);
+        }
+
+        if (running_)
+                schedule();
+}
@@ -0,0 +1,111 @@
+/**
+ * @file tick_scheduler.h
+ * @brief Drift-free fixed-rate tick scheduling on an asio io_context
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#pragma once
+#include <asio.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+/**
+ * @class TickScheduler
+ * @brief Invokes a handler at a fixed rate using absolute deadlines
+ *
+ * Each deadline is computed by adding the period to the previous target rather than
+ * to "now", so handler latency and timer wake-up jitter never accumulate into drift.
+ * When the process falls behind (e.g. a long tick or a descheduled thread), the
+ * overload policy decides whether missed ticks are run back to back or dropped.
+ */
+class TickScheduler
+{
+public:
+        /**
+         * @enum OverloadPolicy
+         * @brief What to do when one or more deadlines have already passed
+         */
+        enum class OverloadPolicy
+        {
+                CATCH_UP,  ///< Run missed ticks back to back (up to max_catch_up per wake-up), then skip the rest
+                SKIP       ///< Run a single tick and drop every other missed deadline
+        };
+
+        /**
+         * @struct Stats
+         * @brief Wake-up jitter and overload statistics
+         */
+        struct Stats
+        {
+                uint64_t ticks_run      = 0;  ///< Handler invocations
+                uint64_t ticks_skipped  = 0;  ///< Deadlines dropped because the scheduler fell too far behind
+                uint64_t wakeups        = 0;  ///< Timer completions
+                uint64_t late_wakeups   = 0;  ///< Wake-ups that were at least one full period late
+                int64_t max_jitter_us   = 0;  ///< Worst wake-up lateness (microseconds)
+                int64_t total_jitter_us = 0;  ///< Sum of wake-up lateness (microseconds)
+
+                /**
+                 * @brief Get mean wake-up lateness
+                 * @return Mean jitter in microseconds
+                 */
+                double mean_jitter_us() const
+                {
+                        return wakeups ? static_cast<double>(total_jitter_us) / static_cast<double>(wakeups) : 0.0;
+                }
+        };
+
+        using TickHandler = std::function<void(uint64_t tick)>;
+
+        /**
+         * @brief Construct tick scheduler
+         * @param io ASIO I/O context the timer runs on
+         * @param period Interval between ticks
+         * @param handler Callback invoked once per tick with the tick number
+         * @param policy Behaviour when deadlines are missed
+         * @param max_catch_up Max ticks run per wake-up under CATCH_UP
+         */
+        TickScheduler(asio::io_context& io,
+                      std::chrono::nanoseconds period,
+                      TickHandler handler,
+                      OverloadPolicy policy = OverloadPolicy::CATCH_UP,
+                      uint32_t max_catch_up = 5);
+
+        /**
+         * @brief Start ticking; the first tick runs one period from now
+         */
+        void start();
+
+        /**
+         * @brief Stop ticking and cancel the pending wake-up
+         */
+        void stop();
+
+        /**
+         * @brief Get scheduling statistics
+         * @return Jitter and overload counters
+         */
+        const Stats& stats() const { return stats_; }
+
+        /**
+         * @brief Get the number of the next tick to run
+         * @return Tick counter (skipped deadlines are not counted)
+         */
+        uint64_t current_tick() const { return tick_; }
+
+private:
+        void schedule();
+        void on_timer();
+
+        asio::steady_timer timer_;
+        std::chrono::nanoseconds period_;
+        TickHandler handler_;
+        OverloadPolicy policy_;
+        uint32_t max_catch_up_;
+
+        std::chrono::steady_clock::time_point next_deadline_;  ///< Absolute target of the next tick
+        uint64_t tick_;
+        bool running_;
+        Stats stats_;
+};
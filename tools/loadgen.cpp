@@ -0,0 +1,289 @@
+/**
+ * @file loadgen.cpp
+ * @brief Headless load generator: many scripted GameClients in one process
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#include "client.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace
+{
+        constexpr uint32_t INPUT_RATE = 60;  ///< Steering updates per second per bot (GameClient sends at its own rate)
+
+        /**
+         * @brief Random-walk direction for a bot, changing every half second
+         * @param seed Run seed
+         * @param bot Bot index
+         * @param step Input step counter
+         * @param dx Output direction X
+         * @param dy Output direction Y
+         */
+        void walk_direction(uint32_t seed, uint32_t bot, uint64_t step, float& dx, float& dy)
+        {
+                uint64_t x = (static_cast<uint64_t>(seed) << 32) ^ (static_cast<uint64_t>(bot) * 0x9E3779B97F4A7C15ull) ^
+                             (step / (INPUT_RATE / 2));
+                x ^= x >> 33;
+                x *= 0xFF51AFD7ED558CCDull;
+                x ^= x >> 33;
+
+                static const float dirs[9][2] = {
+                    {0.0f, 0.0f}, {1.0f, 0.0f}, {-1.0f, 0.0f}, {0.0f, 1.0f}, {0.0f, -1.0f},
+                    {1.0f, 1.0f}, {1.0f, -1.0f}, {-1.0f, 1.0f}, {-1.0f, -1.0f}};
+                dx = dirs[x % 9][0];
+                dy = dirs[x % 9][1];
+        }
+
+        /**
+         * @brief Share of a bot's interpolation updates that had to extrapolate
+         * @param s Bot statistics
+         * @return Percentage (0 before any update)
+         */
+        double extrapolated_pct(const NetStats& s)
+        {
+                return s.frames_rendered ? 100.0 * static_cast<double>(s.frames_extrapolated) / s.frames_rendered : 0.0;
+        }
+
+        /**
+         * @class LoadGenerator
+         * @brief Drives a set of bots from timers on a shared io_context
+         */
+        class LoadGenerator
+        {
+        public:
+                LoadGenerator(asio::io_context& io, uint32_t seed)
+                    : io_(io), input_timer_(io), report_timer_(io), seed_(seed), step_(0), last_bytes_(0)
+                {
+                }
+
+                /**
+                 * @brief Connect bots to the server
+                 * @param host Server host
+                 * @param port Server port
+                 * @param count Number of bots
+                 * @return Number of bots that connected
+                 */
+                size_t connect(const std::string& host, uint16_t port, uint32_t count)
+                {
+                        for (uint32_t i = 0; i < count; ++i)
+                        {
+                                auto bot = std::make_unique<GameClient>(io_);
+                                try
+                                {
+                                        bot->connect(host, port);
+                                }
+                                catch (std::exception& e)
+                                {
+                                        std::cerr << "Bot " << i << " failed to connect: " << e.what() << "\n";
+                                        break;
+                                }
+                                bots_.push_back(std::move(bot));
+                        }
+                        return bots_.size();
+                }
+
+                /**
+                 * @brief Start sending inputs and printing per-second summaries
+                 */
+                void start()
+                {
+                        start_time_  = std::chrono::steady_clock::now();
+                        next_input_  = start_time_;
+                        last_report_ = start_time_;
+                        last_bytes_  = 0;
+                        schedule_input();
+                        schedule_report();
+                }
+
+                /**
+                 * @brief Print one CSV line per bot
+                 */
+                void print_bot_stats() const
+                {
+                        std::cout << "bot,player_id,ping_ms,snapshots,interval_mean_ms,interval_jitter_ms,"
+                                     "interval_max_ms,bytes_received,clock_offset_ms,clock_rtt_ms,interp_delay_ms,arrival_jitter_ms,"
+                                     "extrapolated_pct\n";
+                        for (size_t i = 0; i < bots_.size(); ++i)
+                        {
+                                NetStats s = bots_[i]->get_net_stats();
+                                std::cout << i << "," << bots_[i]->get_my_id() << "," << s.ping_ms << ","
+                                          << s.snapshots_received << "," << s.interval_mean_ms << ","
+                                          << s.interval_jitter_ms << "," << s.interval_max_ms << "," << s.bytes_received
+                                          << "," << s.clock_offset_ms << "," << s.clock_rtt_ms << "," << s.interp_delay_ms << ","
+                                          << s.arrival_jitter_ms << "," << extrapolated_pct(s) << "\n";
+                        }
+                }
+
+                /**
+                 * @brief Print latency percentiles merged over all bots
+                 */
+                void print_latency_summary() const
+                {
+                        LatencyHistograms merged;
+                        for (const auto& bot : bots_)
+                        {
+                                LatencyHistograms h = bot->get_latency_histograms();
+                                merged.input_rtt_ms.merge(h.input_rtt_ms);
+                                merged.snapshot_interval_us.merge(h.snapshot_interval_us);
+                                merged.inbox_wait_us.merge(h.inbox_wait_us);
+                                merged.step_us.merge(h.step_us);
+                        }
+
+                        std::cout << "input rtt:         " << merged.input_rtt_ms.summary("ms") << "\n"
+                                  << "snapshot interval: " << merged.snapshot_interval_us.summary() << "\n"
+                                  << "inbox wait:        " << merged.inbox_wait_us.summary() << "\n"
+                                  << "simulation step:   " << merged.step_us.summary() << "\n";
+                }
+
+        private:
+                void schedule_input()
+                {
+                        // Absolute deadlines so the input rate does not drift under load
+                        next_input_ += std::chrono::microseconds(1000000 / INPUT_RATE);
+                        input_timer_.expires_at(next_input_);
+                        input_timer_.async_wait(
+                            [this](asio::error_code ec)
+                            {
+                                    if (ec)
+                                            return;
+
+                                    for (uint32_t i = 0; i < bots_.size(); ++i)
+                                    {
+                                            float dx, dy;
+                                            walk_direction(seed_, i, step_, dx, dy);
+                                            bots_[i]->set_input(dx, dy);
+
+                                            // This thread is every bot's simulation stage as well as its network stage:
+                                            // apply queued snapshots, sample the input and interpolate
+                                            bots_[i]->step(1.0f / INPUT_RATE);
+                                    }
+                                    step_++;
+                                    schedule_input();
+                            });
+                }
+
+                void schedule_report()
+                {
+                        report_timer_.expires_after(std::chrono::seconds(1));
+                        report_timer_.async_wait(
+                            [this](asio::error_code ec)
+                            {
+                                    if (ec)
+                                            return;
+
+                                    size_t connected    = 0;
+                                    uint64_t bytes      = 0;
+                                    double ping_sum     = 0.0;
+                                    double worst_jitter = 0.0;
+                                    double delay_sum    = 0.0;
+                                    uint64_t frames     = 0;
+                                    uint64_t extra      = 0;
+                                    uint64_t predicted  = 0;
+                                    uint64_t rolled     = 0;
+                                    for (const auto& bot : bots_)
+                                    {
+                                            NetStats s = bot->get_net_stats();
+                                            connected   += bot->is_connected() ? 1 : 0;
+                                            bytes       += s.bytes_received;
+                                            ping_sum    += s.ping_ms;
+                                            worst_jitter = std::max(worst_jitter, s.interval_jitter_ms);
+                                            delay_sum   += s.interp_delay_ms;
+                                            frames      += s.frames_rendered;
+                                            extra       += s.frames_extrapolated;
+                                            predicted   += s.pickups_predicted;
+                                            rolled      += s.pickups_rolled_back;
+                                    }
+
+                                    auto now       = std::chrono::steady_clock::now();
+                                    double seconds = std::chrono::duration<double>(now - last_report_).count();
+                                    auto elapsed   = std::chrono::duration_cast<std::chrono::seconds>(now - start_time_);
+                                    std::cout << "[" << elapsed.count() << "s] connected " << connected << "/"
+                                              << bots_.size() << ", rx " << (bytes - last_bytes_) / seconds / 1024.0 << " KiB/s, mean ping "
+                                              << (bots_.empty() ? 0.0 : ping_sum / bots_.size())
+                                              << " ms, worst snapshot jitter " << worst_jitter << " ms, mean interp delay "
+                                              << (bots_.empty() ? 0.0 : delay_sum / bots_.size()) << " ms, extrapolated "
+                                              << (frames ? 100.0 * extra / frames : 0.0) << "%, predicted pickups "
+                                              << predicted << " (" << rolled << " rolled back)\n";
+
+                                    last_report_ = now;
+                                    last_bytes_  = bytes;
+                                    schedule_report();
+                            });
+                }
+
+                asio::io_context& io_;
+                asio::steady_timer input_timer_;
+                asio::steady_timer report_timer_;
+                std::vector<std::unique_ptr<GameClient>> bots_;
+                uint32_t seed_;
+                uint64_t step_;  ///< Input steps sent so far
+                std::chrono::steady_clock::time_point start_time_;
+                std::chrono::steady_clock::time_point next_input_;
+                std::chrono::steady_clock::time_point last_report_;
+                uint64_t last_bytes_;  ///< Total bytes at the previous report
+        };
+}  // namespace
+
+/**
+ * @brief Load generator entry point
+ * @param argc Argument count
+ * @param argv Arguments: [host] [port] [--bots N] [--seconds N] [--seed N]
+ * @return 0 on success, 1 on error
+ */
+int main(int argc, char* argv[])
+{
+        try
+        {
+                std::string host = "127.0.0.1";
+                uint16_t port    = 12345;
+                uint32_t bots    = 100;
+                uint32_t seconds = 30;
+                uint32_t seed    = 1;
+
+                int positional = 0;
+                for (int i = 1; i < argc; ++i)
+                {
+                        if (std::strcmp(argv[i], "--bots") == 0 && i + 1 < argc)
+                                bots = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+                        else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+                                seconds = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+                        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+                                seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+                        else if (positional++ == 0)
+                                host = argv[i];
+                        else
+                                port = static_cast<uint16_t>(std::atoi(argv[i]));
+                }
+
+                asio::io_context io;
+                LoadGenerator generator(io, seed);
+
+                size_t connected = generator.connect(host, port, bots);
+                std::cout << "Connected " << connected << "/" << bots << " bots to " << host << ":" << port
+                          << ", running for " << seconds << " s\n";
+                if (connected == 0)
+                        return 1;
+
+                asio::steady_timer stop_timer(io, std::chrono::seconds(seconds));
+                stop_timer.async_wait([&io](asio::error_code) { io.stop(); });
+
+                generator.start();
+                io.run();
+
+                generator.print_bot_stats();
+                generator.print_latency_summary();
+        }
+        catch (std::exception& e)
+        {
+                std::cerr << "Loadgen error: " << e.what() << "\n";
+                return 1;
+        }
+
+        return 0;
+}
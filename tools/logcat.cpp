@@ -0,0 +1,44 @@
+/**
+ * @file logcat.cpp
+ * @brief Print a binary server log (logging::BinarySink) as text
+ * @author NetworkGame Project
+ * @date 2024
+ */
+
+#include "log.h"
+#include <iostream>
+
+/**
+ * @brief Log decoder entry point
+ * @param argc Argument count
+ * @param argv Arguments: <binary log>
+ * @return 0 on success, 1 on error
+ */
+int main(int argc, char* argv[])
+{
+        if (argc < 2)
+        {
+                std::cerr << "Usage: logcat <binary log>\n";
+                return 1;
+        }
+
+        try
+        {
+                logging::BinaryReader reader(argv[1]);
+                logging::Record record;
+                std::string line;
+                while (reader.next(record))
+                {
+                        line.clear();
+                        logging::format_line(record, line);
+                        std::cout << line;
+                }
+        }
+        catch (std::exception& e)
+        {
+                std::cerr << "Logcat error: " << e.what() << "\n";
+                return 1;
+        }
+
+        return 0;
+}